@@ -0,0 +1,88 @@
+#include "ChunkedMap.h"
+#include <cstdio>
+#include <algorithm>
+
+DirectoryChunkLoader::DirectoryChunkLoader(const std::string& directory) {
+    m_directory = directory;
+}
+
+std::string DirectoryChunkLoader::chunkFileName(const std::string& directory, int chunkX, int chunkY) {
+    return directory + "/" + std::to_string(chunkX) + "_" + std::to_string(chunkY) + ".chunk";
+}
+
+bool DirectoryChunkLoader::loadChunk(int chunkX, int chunkY, int chunkSize, std::vector<PathFinder::MapCell>& cells) {
+    FILE* file = fopen(chunkFileName(m_directory, chunkX, chunkY).c_str(), "rb");
+    if (!file)
+        return false;
+
+    cells.resize((size_t)chunkSize * chunkSize);
+    bool complete = fread(cells.data(), 1, cells.size(), file) == cells.size();
+    fclose(file);
+    return complete;
+}
+
+bool DirectoryChunkLoader::saveChunk(const std::string& directory, int chunkX, int chunkY, const std::vector<PathFinder::MapCell>& cells) {
+    FILE* file = fopen(chunkFileName(directory, chunkX, chunkY).c_str(), "wb");
+    if (!file)
+        return false;
+
+    bool written = fwrite(cells.data(), 1, cells.size(), file) == cells.size();
+    return fclose(file) == 0 && written;
+}
+
+ChunkedMap::ChunkedMap(ChunkLoader& loader, int chunkSize, int chunksX, int chunksY, int cacheCapacity) : m_loader(loader) {
+    m_chunkSize = std::max(1, chunkSize);
+    m_chunksX = std::max(0, chunksX);
+    m_chunksY = std::max(0, chunksY);
+    m_cacheCapacity = std::max(1, cacheCapacity);
+    m_hits = m_misses = m_evictions = 0;
+    m_generation = 0;
+}
+
+const PathFinder::MapCell* ChunkedMap::getChunk(int chunkX, int chunkY) {
+    if (chunkX < 0 || chunkY < 0 || chunkX >= m_chunksX || chunkY >= m_chunksY)
+        return nullptr;
+
+    int64_t key = (int64_t)chunkY * m_chunksX + chunkX;
+    auto found = m_index.find(key);
+    if (found != m_index.end()) {
+        m_hits++;
+        m_chunks.splice(m_chunks.begin(), m_chunks, found->second);
+        return found->second->exists ? found->second->cells.data() : nullptr;
+    }
+
+    m_misses++;
+    m_generation++;
+    // the evicted chunk's buffer is reused for the new one
+    std::list<Chunk> chunk;
+    if ((int)m_chunks.size() >= m_cacheCapacity) {
+        chunk.splice(chunk.begin(), m_chunks, std::prev(m_chunks.end()));
+        m_index.erase(chunk.front().key);
+        m_evictions++;
+    }
+    else {
+        chunk.emplace_back();
+    }
+
+    Chunk& loaded = chunk.front();
+    loaded.key = key;
+    loaded.exists = m_loader.loadChunk(chunkX, chunkY, m_chunkSize, loaded.cells) &&
+        loaded.cells.size() == (size_t)m_chunkSize * m_chunkSize;
+    // missing chunks stay cached too, so the loader isn't asked again and again
+    if (!loaded.exists)
+        loaded.cells.clear();
+
+    m_chunks.splice(m_chunks.begin(), chunk);
+    m_index[key] = m_chunks.begin();
+    return loaded.exists ? loaded.cells.data() : nullptr;
+}
+
+PathFinder::MapCell ChunkedMap::getCell(int x, int y) {
+    if (x < 0 || y < 0)
+        return PathFinder::MapCell::WALL;
+
+    const PathFinder::MapCell* chunk = getChunk(x / m_chunkSize, y / m_chunkSize);
+    if (!chunk)
+        return PathFinder::MapCell::WALL;
+    return chunk[(size_t)(y % m_chunkSize) * m_chunkSize + x % m_chunkSize];
+}
\ No newline at end of file
@@ -0,0 +1,81 @@
+#ifndef __CHUNKED_MAP_H__
+#define __CHUNKED_MAP_H__
+#include "PathFinder.h"
+#include <vector>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <cstdint>
+
+/*
+world map made of square tiles (chunks) that are loaded on demand.
+a ChunkLoader supplies the cells of a chunk, ChunkedMap keeps the most recently used chunks
+in a cache of fixed capacity and drops the least recently used one when it is full.
+cells outside of the world and in chunks the loader doesn't have are walls.
+
+DirectoryChunkLoader loader("world");
+ChunkedMap world(loader, 256, 1024, 1024, 64);
+*/
+class ChunkLoader {
+public:
+	virtual ~ChunkLoader() {}
+	// fills cells with chunkSize * chunkSize cells row by row, false if there is no such chunk
+	virtual bool loadChunk(int chunkX, int chunkY, int chunkSize, std::vector<PathFinder::MapCell>& cells) = 0;
+};
+
+// one file per chunk named <chunkX>_<chunkY>.chunk in a directory, one byte per cell
+class DirectoryChunkLoader : public ChunkLoader {
+public:
+	explicit DirectoryChunkLoader(const std::string& directory);
+
+	bool loadChunk(int chunkX, int chunkY, int chunkSize, std::vector<PathFinder::MapCell>& cells) override;
+	static bool saveChunk(const std::string& directory, int chunkX, int chunkY, const std::vector<PathFinder::MapCell>& cells);
+private:
+	static std::string chunkFileName(const std::string& directory, int chunkX, int chunkY);
+
+	std::string m_directory;
+};
+
+class ChunkedMap {
+public:
+	// the world is chunksX * chunksY chunks, cacheCapacity chunks are kept in memory at most
+	ChunkedMap(ChunkLoader& loader, int chunkSize, int chunksX, int chunksY, int cacheCapacity);
+
+	PathFinder::MapCell getCell(int x, int y);
+	// cells of a chunk row by row, nullptr if the loader has no such chunk.
+	// the pointer stays valid until getGeneration() changes
+	const PathFinder::MapCell* getChunk(int chunkX, int chunkY);
+
+	int getWidth() { return m_chunksX * m_chunkSize; }
+	int getHeight() { return m_chunksY * m_chunkSize; }
+	int getChunkSize() { return m_chunkSize; }
+	int getCacheCapacity() { return m_cacheCapacity; }
+	int getCachedChunkCount() { return (int)m_chunks.size(); }
+
+	long long getHits() { return m_hits; }
+	long long getMisses() { return m_misses; }
+	long long getEvictions() { return m_evictions; }
+	void resetCounters() { m_hits = m_misses = m_evictions = 0; }
+	// changes whenever a chunk is loaded, which may evict others
+	uint64_t getGeneration() { return m_generation; }
+private:
+	struct Chunk {
+		int64_t key;
+		bool exists;
+		std::vector<PathFinder::MapCell> cells;
+	};
+
+	ChunkLoader& m_loader;
+	int m_chunkSize;
+	int m_chunksX, m_chunksY;
+	int m_cacheCapacity;
+
+	// most recently used chunk first
+	std::list<Chunk> m_chunks;
+	std::unordered_map<int64_t, std::list<Chunk>::iterator> m_index;
+
+	long long m_hits, m_misses, m_evictions;
+	uint64_t m_generation;
+};
+
+#endif //!__CHUNKED_MAP_H__
\ No newline at end of file
@@ -0,0 +1,204 @@
+#include "ChunkedPathFinder.h"
+#include <algorithm>
+
+ChunkedPathFinder::ChunkedPathFinder(ChunkedMap& map) : m_map(map) {
+    m_chunkSize = map.getChunkSize();
+    m_waveStep = -1;
+    m_startX = m_startY = m_endX = m_endY = 0;
+    m_reachedPoint = false;
+    m_lastMapKey = m_lastStepsKey = -1;
+    m_lastMapChunk = nullptr;
+    m_lastMapGeneration = 0;
+    m_lastSteps = nullptr;
+}
+
+bool ChunkedPathFinder::setEndpoints(int startX, int startY, int endX, int endY) {
+    auto isInside = [this](int x, int y) { return x >= 0 && y >= 0 && x < m_map.getWidth() && y < m_map.getHeight(); };
+    if (!isInside(startX, startY) || !isInside(endX, endY))
+        return false;
+
+    m_startX = startX;
+    m_startY = startY;
+    m_endX = endX;
+    m_endY = endY;
+    reset();
+    return true;
+}
+
+void ChunkedPathFinder::reset() {
+    // the buffers of the last search are cleared and kept, the next search takes them before it allocates
+    const size_t chunkCells = (size_t)m_chunkSize * m_chunkSize;
+    for (size_t slot : m_usedSlots) {
+        int* steps = m_stepSlots[slot].second;
+        std::fill(steps, steps + chunkCells, -1);
+        m_freeSteps.push_back(steps);
+        m_stepSlots[slot].first = -1;
+    }
+    m_usedSlots.clear();
+    m_lastStepsKey = -1;
+    m_lastSteps = nullptr;
+
+    m_waveStep = 0;
+    m_reachedPoint = m_startX == m_endX && m_startY == m_endY;
+    m_wave.clear();
+    m_oldWave.clear();
+    m_finalPath.clear();
+    m_oldWave.push_back({ m_startX, m_startY });
+    chunkSteps(m_startX, m_startY, true)[(m_startY % m_chunkSize) * m_chunkSize + m_startX % m_chunkSize] = 0;
+}
+
+bool ChunkedPathFinder::isFree(int x, int y) {
+    if (x < 0 || y < 0 || x >= m_map.getWidth() || y >= m_map.getHeight())
+        return false;
+
+    int chunkX = x / m_chunkSize, chunkY = y / m_chunkSize;
+    int64_t key = (int64_t)chunkY * (m_map.getWidth() / m_chunkSize) + chunkX;
+    // a load may have evicted the remembered chunk, the generation tells
+    if (key != m_lastMapKey || m_map.getGeneration() != m_lastMapGeneration) {
+        m_lastMapChunk = m_map.getChunk(chunkX, chunkY);
+        m_lastMapKey = key;
+        m_lastMapGeneration = m_map.getGeneration();
+    }
+    if (!m_lastMapChunk)
+        return false;
+    return m_lastMapChunk[(y % m_chunkSize) * m_chunkSize + x % m_chunkSize] != PathFinder::MapCell::WALL;
+}
+
+size_t ChunkedPathFinder::findSlot(int64_t key) const {
+    const size_t mask = m_stepSlots.size() - 1;
+    size_t slot = (size_t)(((uint64_t)key * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+    while (m_stepSlots[slot].first != -1 && m_stepSlots[slot].first != key)
+        slot = (slot + 1) & mask;
+    return slot;
+}
+
+// doubles the table, only while the finder warms up to its largest search
+void ChunkedPathFinder::growSlots() {
+    std::vector<std::pair<int64_t, int*>> slots = std::move(m_stepSlots);
+    m_stepSlots.assign(std::max<size_t>(64, slots.size() * 2), { -1, nullptr });
+    for (size_t& slot : m_usedSlots) {
+        const std::pair<int64_t, int*>& entry = slots[slot];
+        slot = findSlot(entry.first);
+        m_stepSlots[slot] = entry;
+    }
+}
+
+int* ChunkedPathFinder::chunkSteps(int x, int y, bool create) {
+    int64_t key = (int64_t)(y / m_chunkSize) * (m_map.getWidth() / m_chunkSize) + x / m_chunkSize;
+    if (key == m_lastStepsKey)
+        return m_lastSteps;
+    if (m_stepSlots.empty()) {
+        if (!create)
+            return nullptr;
+        growSlots();
+    }
+
+    size_t slot = findSlot(key);
+    if (m_stepSlots[slot].first == -1) {
+        if (!create)
+            return nullptr;
+        // at most half of the slots are filled, so probes stay short
+        if ((m_usedSlots.size() + 1) * 2 > m_stepSlots.size()) {
+            growSlots();
+            slot = findSlot(key);
+        }
+
+        int* steps;
+        if (!m_freeSteps.empty()) {
+            steps = m_freeSteps.back();
+            m_freeSteps.pop_back();
+        }
+        else {
+            const size_t chunkCells = (size_t)m_chunkSize * m_chunkSize;
+            m_stepBuffers.push_back(std::make_unique<int[]>(chunkCells));
+            steps = m_stepBuffers.back().get();
+            std::fill(steps, steps + chunkCells, -1);
+        }
+        m_stepSlots[slot] = { key, steps };
+        m_usedSlots.push_back(slot);
+    }
+    // buffers never move, the pointer stays valid while the table grows
+    m_lastStepsKey = key;
+    m_lastSteps = m_stepSlots[slot].second;
+    return m_lastSteps;
+}
+
+int ChunkedPathFinder::stepAt(int x, int y) {
+    if (x < 0 || y < 0 || x >= m_map.getWidth() || y >= m_map.getHeight())
+        return -1;
+    int* steps = chunkSteps(x, y, false);
+    return steps ? steps[(y % m_chunkSize) * m_chunkSize + x % m_chunkSize] : -1;
+}
+
+void ChunkedPathFinder::processStep() {
+    if (m_reachedPoint || m_oldWave.empty())
+        return;
+
+    // up, right, down, left
+    const int dx[4] = { 0, 1, 0, -1 };
+    const int dy[4] = { -1, 0, 1, 0 };
+
+    int nextStep = m_waveStep + 1;
+    m_wave.clear();
+
+    for (const Point& current : m_oldWave) {
+        for (int d = 0; d < 4; d++) {
+            int x = current.x + dx[d], y = current.y + dy[d];
+            if (!isFree(x, y))
+                continue;
+
+            int& step = chunkSteps(x, y, true)[(y % m_chunkSize) * m_chunkSize + x % m_chunkSize];
+            if (step != -1)
+                continue;
+
+            step = nextStep;
+            m_wave.push_back({ x, y });
+
+            if (x == m_endX && y == m_endY) {
+                m_reachedPoint = true;
+                break;
+            }
+        }
+        if (m_reachedPoint)
+            break;
+    }
+    m_waveStep = nextStep;
+    m_oldWave.swap(m_wave);
+}
+
+void ChunkedPathFinder::process() {
+    while (!m_oldWave.empty() && !m_reachedPoint)
+        processStep();
+
+    m_finalPath.clear();
+    if (!m_reachedPoint)
+        return;
+
+    // down the step numbers from END to START
+    const int dx[4] = { 0, 1, 0, -1 };
+    const int dy[4] = { -1, 0, 1, 0 };
+    int x = m_endX, y = m_endY;
+    m_finalPath.push_back({ x, y });
+    while (x != m_startX || y != m_startY) {
+        int previous = stepAt(x, y) - 1;
+        int d = 0;
+        while (d < 4 && stepAt(x + dx[d], y + dy[d]) != previous)
+            d++;
+        if (d == 4)
+            break;
+
+        x += dx[d];
+        y += dy[d];
+        m_finalPath.push_back({ x, y });
+    }
+    std::reverse(m_finalPath.begin(), m_finalPath.end());
+}
+
+int ChunkedPathFinder::distanceTo(int x, int y) {
+    return stepAt(x, y);
+}
+
+size_t ChunkedPathFinder::getMemoryUsage() const {
+    return m_stepBuffers.size() * (size_t)m_chunkSize * m_chunkSize * sizeof(int)
+        + m_stepSlots.capacity() * sizeof(m_stepSlots[0]);
+}
\ No newline at end of file
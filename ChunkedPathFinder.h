@@ -0,0 +1,79 @@
+#ifndef __CHUNKED_PATH_FINDER_H__
+#define __CHUNKED_PATH_FINDER_H__
+#include "ChunkedMap.h"
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+/*
+wave search over a ChunkedMap
+the wave crosses chunk borders like any other cell, the map chunks come from the cache and
+the wave steps are kept per chunk in buffers handed out when the wave first enters a chunk.
+memory grows with the area a search touches, not with the size of the world. reset() refills
+only the buffers of the last search and keeps them for the next one, so a warmed up finder
+doesn't allocate and holds as many buffers as its largest search needed.
+
+ChunkedPathFinder search(world);
+search.setEndpoints(10, 10, 70000, 4000);
+search.process();
+*/
+class ChunkedPathFinder {
+public:
+	explicit ChunkedPathFinder(ChunkedMap& map);
+
+	// resets the search, returns false if a point lies outside of the world
+	bool setEndpoints(int startX, int startY, int endX, int endY);
+	void reset();
+
+	void process();
+	void processStep();
+
+	bool isPointReached() { return m_reachedPoint; }
+	std::vector<std::pair<int, int>> getFinalPath() { return m_finalPath; }
+	// wave steps from START to (x, y) or -1 if the wave hasn't labelled it
+	int distanceTo(int x, int y);
+
+	// chunks the current search has labelled cells in
+	int getTouchedChunkCount() { return (int)m_usedSlots.size(); }
+	// bytes of all step buffers, in use or kept for the next search
+	size_t getMemoryUsage() const;
+protected:
+	struct Point {
+		int x, y;
+	};
+
+	bool isFree(int x, int y);
+	// wave steps of the chunk holding (x, y), taken filled with -1 on first use
+	int* chunkSteps(int x, int y, bool create);
+	int stepAt(int x, int y);
+	// slot of key in m_stepSlots or the free slot it would go to
+	size_t findSlot(int64_t key) const;
+	void growSlots();
+
+	ChunkedMap& m_map;
+	int m_chunkSize;
+
+	// open addressing table of the chunks the current search touched: chunk key and step buffer, key -1
+	// marks a free slot. m_usedSlots lists the filled slots, so reset() empties them without a scan
+	std::vector<std::pair<int64_t, int*>> m_stepSlots;
+	std::vector<size_t> m_usedSlots;
+	// every step buffer created, the ones no search uses wait in m_freeSteps already filled with -1
+	std::vector<std::unique_ptr<int[]>> m_stepBuffers;
+	std::vector<int*> m_freeSteps;
+	std::vector<Point> m_wave;
+	std::vector<Point> m_oldWave;
+	std::vector<std::pair<int, int>> m_finalPath;
+	int m_waveStep;
+
+	int m_startX, m_startY, m_endX, m_endY;
+	bool m_reachedPoint;
+
+	// the last chunk asked for, neighbours mostly share it
+	int64_t m_lastMapKey;
+	const PathFinder::MapCell* m_lastMapChunk;
+	uint64_t m_lastMapGeneration;
+	int64_t m_lastStepsKey;
+	int* m_lastSteps;
+};
+
+#endif //!__CHUNKED_PATH_FINDER_H__
\ No newline at end of file
@@ -0,0 +1,285 @@
+#include "CompactPathFinder.h"
+#include <algorithm>
+#include <cstring>
+
+typedef PathFinder::MapCell MapCell;
+
+// exact wave steps in T, the largest value marks unvisited cells
+template<typename T>
+struct PlainDistances {
+    T* steps;
+
+    bool isVisited(size_t index) const { return steps[index] != (T)~T(0); }
+    int code(size_t index) const { return steps[index]; }
+    void label(size_t index, int step) { steps[index] = (T)step; }
+    static int previousCode(int code) { return code - 1; }
+};
+
+// step % 3 in 2 bits, 3 marks unvisited cells
+struct Mod3Distances {
+    uint64_t* words;
+
+    int code(size_t index) const { return (int)((words[index >> 5] >> ((index & 31) * 2)) & 3); }
+    bool isVisited(size_t index) const { return code(index) != 3; }
+    void label(size_t index, int step) {
+        int shift = (index & 31) * 2;
+        words[index >> 5] = (words[index >> 5] & ~(3ULL << shift)) | ((uint64_t)(step % 3) << shift);
+    }
+    static int previousCode(int code) { return (code + 2) % 3; }
+};
+
+CompactPathFinder::CompactPathFinder() {
+    m_distanceBits = 8;
+    m_distanceStorage = DistanceStorage::ADAPTIVE;
+    m_freeCells = 0;
+    m_waveStep = -1;
+    m_mapWidth = m_mapHeight = 0;
+    m_stride = 2;
+    m_mapSize = 0;
+    m_startX = m_startY = m_endX = m_endY = 0;
+    m_reachedPoint = false;
+    m_floodAll = false;
+}
+
+template<class Function>
+auto CompactPathFinder::withDistances(Function function) {
+    void* steps = m_distanceWords.data();
+    switch (m_distanceBits) {
+    case 2:
+        return function(Mod3Distances{ m_distanceWords.data() });
+    case 8:
+        return function(PlainDistances<uint8_t>{ (uint8_t*)steps });
+    case 16:
+        return function(PlainDistances<uint16_t>{ (uint16_t*)steps });
+    default:
+        return function(PlainDistances<uint32_t>{ (uint32_t*)steps });
+    }
+}
+
+void CompactPathFinder::allocateMap(int width, int height) {
+    m_mapWidth = width;
+    m_mapHeight = height;
+    m_stride = width + 2;
+    m_mapSize = (size_t)m_stride * (height + 2);
+    // 01 in every 2-bit cell is WALL
+    m_cells.assign((m_mapSize + 31) / 32, 0x5555555555555555ULL);
+    m_startX = m_startY = m_endX = m_endY = 0;
+    m_freeCells = 0;
+}
+
+void CompactPathFinder::storeCell(size_t index, MapCell cell) {
+    int shift = (index & 31) * 2;
+    m_cells[index >> 5] = (m_cells[index >> 5] & ~(3ULL << shift)) | ((uint64_t)cell << shift);
+}
+
+void CompactPathFinder::setMap(const PathFinder::Map& map) {
+    if (map.empty() || map[0].empty())
+        return;
+    for (const std::vector<MapCell>& row : map) {
+        if (row.size() != map[0].size())
+            return;
+    }
+
+    std::vector<MapCell> cells;
+    cells.reserve(map.size() * map[0].size());
+    for (const std::vector<MapCell>& row : map)
+        cells.insert(cells.end(), row.begin(), row.end());
+    setMap(cells, (int)map[0].size());
+}
+
+void CompactPathFinder::setMap(const std::vector<MapCell>& map, int cols) {
+    if (map.empty() || cols < 1 || map.size() % cols != 0)
+        return;
+
+    allocateMap(cols, (int)(map.size() / cols));
+    for (int y = 0; y < m_mapHeight; y++) {
+        for (int x = 0; x < m_mapWidth; x++) {
+            MapCell cell = map[(size_t)y * cols + x];
+            storeCell(cellIndex(x, y), cell);
+            m_freeCells += cell != MapCell::WALL;
+
+            if (cell == MapCell::START) {
+                m_startX = x;
+                m_startY = y;
+            }
+            else if (cell == MapCell::END) {
+                m_endX = x;
+                m_endY = y;
+            }
+        }
+    }
+    chooseDistanceBits();
+    reset();
+}
+
+// no wave step is larger than the number of free cells, the largest value of the type stays free for unvisited
+void CompactPathFinder::chooseDistanceBits() {
+    if (m_distanceStorage == DistanceStorage::MOD3)
+        m_distanceBits = 2;
+    else if (m_freeCells <= 0xFF)
+        m_distanceBits = 8;
+    else if (m_freeCells <= 0xFFFF)
+        m_distanceBits = 16;
+    else
+        m_distanceBits = 32;
+}
+
+void CompactPathFinder::setDistanceStorage(DistanceStorage storage) {
+    m_distanceStorage = storage;
+    chooseDistanceBits();
+    reset();
+}
+
+MapCell CompactPathFinder::getCell(int x, int y) const {
+    if (x < 0 || y < 0 || x >= m_mapWidth || y >= m_mapHeight)
+        return MapCell::WALL;
+    return cellAt(cellIndex(x, y));
+}
+
+bool CompactPathFinder::setEndpoints(int startX, int startY, int endX, int endY) {
+    auto isInside = [this](int x, int y) { return x >= 0 && y >= 0 && x < m_mapWidth && y < m_mapHeight; };
+    if (!isInside(startX, startY) || !isInside(endX, endY))
+        return false;
+
+    // markers move with the points, walls stay walls
+    auto moveMarker = [this](MapCell marker, size_t oldIndex, size_t newIndex) {
+        if (cellAt(oldIndex) == marker)
+            storeCell(oldIndex, MapCell::EMPTY);
+        if (cellAt(newIndex) == MapCell::EMPTY)
+            storeCell(newIndex, marker);
+    };
+    moveMarker(MapCell::START, cellIndex(m_startX, m_startY), cellIndex(startX, startY));
+    moveMarker(MapCell::END, cellIndex(m_endX, m_endY), cellIndex(endX, endY));
+
+    m_startX = startX;
+    m_startY = startY;
+    m_endX = endX;
+    m_endY = endY;
+    reset();
+    return true;
+}
+
+void CompactPathFinder::reset() {
+    if (m_mapSize == 0)
+        return;
+
+    // all ones is unvisited in every storage
+    m_distanceWords.resize((m_mapSize * m_distanceBits + 63) / 64);
+    std::memset(m_distanceWords.data(), 0xFF, m_distanceWords.size() * sizeof(uint64_t));
+
+    m_waveStep = 0;
+    m_reachedPoint = m_startX == m_endX && m_startY == m_endY;
+    m_wave.clear();
+    m_finalPath.clear();
+    m_oldWave.clear();
+    m_oldWave.push_back(cellIndex(m_startX, m_startY));
+    withDistances([&](auto distances) { distances.label(m_oldWave[0], 0); });
+}
+
+void CompactPathFinder::processStep() {
+    if (m_reachedPoint || m_oldWave.empty())
+        return;
+    withDistances([&](auto distances) { processWaveStep(distances); });
+}
+
+template<class Distances>
+void CompactPathFinder::processWaveStep(Distances distances) {
+    const int offsets[4] = { -m_stride, 1, m_stride, -1 };
+    const int endIndex = m_floodAll ? -1 : cellIndex(m_endX, m_endY);
+
+    int nextStep = m_waveStep + 1;
+    m_wave.clear();
+
+    for (int current : m_oldWave) {
+        for (int d = 0; d < 4; d++) {
+            int next = current + offsets[d];
+            if (cellAt(next) == MapCell::WALL || distances.isVisited(next))
+                continue;
+
+            distances.label(next, nextStep);
+            m_wave.push_back(next);
+
+            if (next == endIndex) {
+                m_reachedPoint = true;
+                break;
+            }
+        }
+        if (m_reachedPoint)
+            break;
+    }
+    m_waveStep = nextStep;
+    m_oldWave.swap(m_wave);
+}
+
+void CompactPathFinder::process() {
+    while (!m_oldWave.empty() && !m_reachedPoint)
+        processStep();
+    m_finalPath = m_reachedPoint ? calculatePath(m_endX, m_endY) : std::vector<std::pair<int, int>>();
+}
+
+void CompactPathFinder::processAll() {
+    m_floodAll = true;
+    reset();
+    m_reachedPoint = false;
+    while (!m_oldWave.empty())
+        processStep();
+    m_floodAll = false;
+
+    m_finalPath = calculatePath(m_endX, m_endY);
+    m_reachedPoint = !m_finalPath.empty();
+}
+
+// walks from "from" back to START, every neighbour is at most one step away so the predecessor
+// is the neighbour whose code is the previous one
+template<class Distances>
+bool CompactPathFinder::tracePath(Distances distances, int from, std::vector<std::pair<int, int>>& path) {
+    const int offsets[4] = { -m_stride, 1, m_stride, -1 };
+    const int startIndex = cellIndex(m_startX, m_startY);
+
+    int current = from;
+    path.push_back(cellPoint(current));
+    while (current != startIndex) {
+        int previous = Distances::previousCode(distances.code(current));
+        bool found = false;
+        for (int d = 0; d < 4; d++) {
+            int next = current + offsets[d];
+            if (distances.isVisited(next) && distances.code(next) == previous) {
+                current = next;
+                path.push_back(cellPoint(current));
+                found = true;
+                break;
+            }
+        }
+        if (!found)
+            return false;
+    }
+    return true;
+}
+
+std::vector<std::pair<int, int>> CompactPathFinder::calculatePath(int x, int y) {
+    std::vector<std::pair<int, int>> path;
+    if (x < 0 || y < 0 || x >= m_mapWidth || y >= m_mapHeight || m_distanceWords.empty())
+        return path;
+
+    int from = cellIndex(x, y);
+    withDistances([&](auto distances) {
+        if (distances.isVisited(from) && tracePath(distances, from, path))
+            std::reverse(path.begin(), path.end());
+        else
+            path.clear();
+    });
+    return path;
+}
+
+int CompactPathFinder::distanceTo(int x, int y) {
+    if (x < 0 || y < 0 || x >= m_mapWidth || y >= m_mapHeight || m_distanceWords.empty())
+        return -1;
+
+    if (m_distanceBits == 2) {
+        // only step % 3 is known, the path back to START tells the rest
+        std::vector<std::pair<int, int>> path = calculatePath(x, y);
+        return path.empty() ? -1 : (int)path.size() - 1;
+    }
+    int index = cellIndex(x, y);
+    return withDistances([&](auto distances) { return distances.isVisited(index) ? distances.code(index) : -1; });
+}
\ No newline at end of file
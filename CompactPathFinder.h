@@ -0,0 +1,98 @@
+#ifndef __COMPACT_PATH_FINDER_H__
+#define __COMPACT_PATH_FINDER_H__
+#include "PathFinder.h"
+#include <vector>
+#include <cstdint>
+
+/*
+wave search with compact storage for very large maps
+cells are packed 2 bits each, 32 to a word. Wave steps are stored in the narrowest type
+the map allows: 8, 16 or 32 bits, picked from the number of free cells since no step can be
+larger. With DistanceStorage::MOD3 only step % 3 is kept in 2 bits per cell, which is enough
+to walk a path back: the wave labels neighbours at most one step apart, so the predecessor
+is the one neighbour labelled (step - 1) % 3.
+
+a 16k x 16k map takes 64 MB of cells and 64 MB of MOD3 steps instead of the 1.25 GB
+of a PathFinder.
+
+CompactPathFinder compact;
+compact.setMap(map);
+compact.process();
+std::vector<std::pair<int, int>> path = compact.getFinalPath();
+*/
+class CompactPathFinder {
+public:
+	enum class DistanceStorage {
+		ADAPTIVE,	// exact steps in 8, 16 or 32 bits, distanceTo() is O(1)
+		MOD3		// step % 3 in 2 bits, distanceTo() walks the path back
+	};
+
+	CompactPathFinder();
+
+	void setMap(const PathFinder::Map& map);
+	void setMap(const std::vector<PathFinder::MapCell>& map, int cols);
+	// switching the storage resets the search
+	void setDistanceStorage(DistanceStorage storage);
+	DistanceStorage getDistanceStorage() { return m_distanceStorage; }
+
+	bool setEndpoints(int startX, int startY, int endX, int endY);
+	PathFinder::MapCell getCell(int x, int y) const;
+
+	int getMapWidth() { return m_mapWidth; }
+	int getMapHeight() { return m_mapHeight; }
+
+	void reset();
+	void process();
+	void processStep();
+	// floods everything reachable from START, after that any cell can be asked for
+	void processAll();
+
+	std::vector<std::pair<int, int>> calculatePath(int x, int y);
+	// wave steps from START to (x, y) or -1 if the wave hasn't labelled it
+	int distanceTo(int x, int y);
+
+	bool isPointReached() { return m_reachedPoint; }
+	std::vector<std::pair<int, int>> getFinalPath() { return m_finalPath; }
+
+	// bits per cell used for wave steps: 2, 8, 16 or 32
+	int getDistanceBits() { return m_distanceBits; }
+	// bytes held by the packed cells and the wave steps
+	size_t getMemoryUsage() const { return (m_cells.size() + m_distanceWords.size()) * sizeof(uint64_t); }
+protected:
+	// same padded layout as PathFinder: cell (x, y) is at (y + 1) * m_stride + (x + 1)
+	int cellIndex(int x, int y) const { return (y + 1) * m_stride + (x + 1); }
+	std::pair<int, int> cellPoint(int index) const { return { index % m_stride - 1, index / m_stride - 1 }; }
+
+	PathFinder::MapCell cellAt(size_t index) const { return (PathFinder::MapCell)((m_cells[index >> 5] >> ((index & 31) * 2)) & 3); }
+	void storeCell(size_t index, PathFinder::MapCell cell);
+
+	// 2-bit cells, 32 per word
+	std::vector<uint64_t> m_cells;
+	// wave steps packed into words, m_distanceBits each
+	std::vector<uint64_t> m_distanceWords;
+	int m_distanceBits;
+	DistanceStorage m_distanceStorage;
+	long long m_freeCells;
+
+	std::vector<int> m_wave;
+	std::vector<int> m_oldWave;
+	std::vector<std::pair<int, int>> m_finalPath;
+	int m_waveStep;
+
+	int m_mapWidth, m_mapHeight;
+	int m_stride;
+	size_t m_mapSize;
+	int m_startX, m_startY, m_endX, m_endY;
+	bool m_reachedPoint;
+	bool m_floodAll;
+private:
+	void allocateMap(int width, int height);
+	void chooseDistanceBits();
+
+	template<class Distances> void processWaveStep(Distances distances);
+	template<class Distances> bool tracePath(Distances distances, int from, std::vector<std::pair<int, int>>& path);
+	// calls function with the accessor of the current distance storage
+	template<class Function> auto withDistances(Function function);
+};
+
+#endif //!__COMPACT_PATH_FINDER_H__
\ No newline at end of file
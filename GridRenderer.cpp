@@ -0,0 +1,202 @@
+#include "GridRenderer.h"
+#include <algorithm>
+
+GridRenderer::GridRenderer(sf::Vector2f tileSize, sf::Vector2f spacing, sf::Vector2f offset) {
+    m_tileSize = tileSize;
+    m_spacing = spacing;
+    m_offset = offset;
+    m_width = m_height = 0;
+    m_mapVertices.setPrimitiveType(sf::Quads);
+    m_waveVertices.setPrimitiveType(sf::Quads);
+    m_pathVertices.setPrimitiveType(sf::Quads);
+    m_waveFrom = sf::Color(0, 0, 0, 255);
+    m_waveTo = sf::Color::Green;
+    m_waveGradientSteps = 10;
+    m_pathColor = sf::Color::Blue;
+    m_fontLoaded = false;
+    m_showIndex = false;
+    m_rewrittenQuads = 0;
+}
+
+sf::Vector2f GridRenderer::tilePosition(int x, int y) const {
+    return sf::Vector2f(m_offset.x + x * (m_tileSize.x + m_spacing.x), m_offset.y + y * (m_tileSize.y + m_spacing.y));
+}
+
+void GridRenderer::placeQuad(sf::VertexArray& vertices, size_t quad, sf::Vector2f position) {
+    sf::Vertex* corners = &vertices[quad * 4];
+    corners[0].position = position;
+    corners[1].position = sf::Vector2f(position.x + m_tileSize.x, position.y);
+    corners[2].position = sf::Vector2f(position.x + m_tileSize.x, position.y + m_tileSize.y);
+    corners[3].position = sf::Vector2f(position.x, position.y + m_tileSize.y);
+}
+
+void GridRenderer::colourQuad(sf::VertexArray& vertices, size_t quad, sf::Color color) {
+    sf::Vertex* corners = &vertices[quad * 4];
+    corners[0].color = corners[1].color = corners[2].color = corners[3].color = color;
+    m_rewrittenQuads++;
+}
+
+void GridRenderer::resize(int width, int height) {
+    m_width = std::max(0, width);
+    m_height = std::max(0, height);
+    size_t cells = (size_t)m_width * m_height;
+
+    m_mapVertices.resize(cells * 4);
+    m_waveVertices.resize(cells * 4);
+    m_waveSteps.assign(cells, -1);
+    for (int y = 0; y < m_height; y++) {
+        for (int x = 0; x < m_width; x++) {
+            size_t quad = (size_t)y * m_width + x;
+            placeQuad(m_mapVertices, quad, tilePosition(x, y));
+            placeQuad(m_waveVertices, quad, tilePosition(x, y));
+            colourQuad(m_mapVertices, quad, sf::Color::Transparent);
+            colourQuad(m_waveVertices, quad, sf::Color::Transparent);
+        }
+    }
+    m_pathVertices.clear();
+    m_path.clear();
+}
+
+void GridRenderer::setWaveGradient(sf::Color from, sf::Color to, int steps) {
+    m_waveFrom = from;
+    m_waveTo = to;
+    m_waveGradientSteps = std::max(1, steps);
+    // every labelled cell changes its colour
+    for (size_t quad = 0; quad < m_waveSteps.size(); quad++) {
+        if (m_waveSteps[quad] != -1)
+            colourQuad(m_waveVertices, quad, waveColor(m_waveSteps[quad]));
+    }
+}
+
+sf::Color GridRenderer::waveColor(int step) const {
+    float percent = std::min(1.f, (float)step / m_waveGradientSteps);
+    auto blend = [percent](sf::Uint8 from, sf::Uint8 to) { return (sf::Uint8)(from + (to - from) * percent); };
+    return sf::Color(blend(m_waveFrom.r, m_waveTo.r), blend(m_waveFrom.g, m_waveTo.g), blend(m_waveFrom.b, m_waveTo.b), blend(m_waveFrom.a, m_waveTo.a));
+}
+
+void GridRenderer::setPathColor(sf::Color color) {
+    m_pathColor = color;
+    for (size_t quad = 0; quad < m_path.size(); quad++)
+        colourQuad(m_pathVertices, quad, color);
+}
+
+bool GridRenderer::setFont(const std::string& fileName) {
+    m_fontLoaded = m_font.loadFromFile(fileName);
+    if (m_fontLoaded) {
+        m_indexText.setFont(m_font);
+        m_indexText.setCharacterSize(20);
+        m_indexText.setFillColor(sf::Color::Red);
+    }
+    return m_fontLoaded;
+}
+
+void GridRenderer::setMapCell(int x, int y, sf::Color color) {
+    if (x < 0 || y < 0 || x >= m_width || y >= m_height)
+        return;
+
+    size_t quad = (size_t)y * m_width + x;
+    if (m_mapVertices[quad * 4].color != color)
+        colourQuad(m_mapVertices, quad, color);
+}
+
+void GridRenderer::setWaveCell(int x, int y, int step) {
+    if (x < 0 || y < 0 || x >= m_width || y >= m_height)
+        return;
+
+    size_t quad = (size_t)y * m_width + x;
+    if (m_waveSteps[quad] == step)
+        return;
+
+    m_waveSteps[quad] = step;
+    colourQuad(m_waveVertices, quad, step == -1 ? sf::Color::Transparent : waveColor(step));
+}
+
+void GridRenderer::updateMap(PathFinder::GridView<PathFinder::MapCell> map) {
+    if (map.width != m_width || map.height != m_height)
+        resize(map.width, map.height);
+
+    for (int y = 0; y < map.height; y++) {
+        for (int x = 0; x < map.width; x++) {
+            switch (map[y][x]) {
+            default:
+            case PathFinder::MapCell::EMPTY:
+                setMapCell(x, y, sf::Color::Transparent);
+                break;
+            case PathFinder::MapCell::WALL:
+                setMapCell(x, y, sf::Color::White);
+                break;
+            case PathFinder::MapCell::START:
+                setMapCell(x, y, sf::Color::Yellow);
+                break;
+            case PathFinder::MapCell::END:
+                setMapCell(x, y, sf::Color::Red);
+                break;
+            }
+        }
+    }
+}
+
+void GridRenderer::updateWave(PathFinder::GridView<int> waveMatrix) {
+    // no search has run yet, every cell is unlabelled
+    if (waveMatrix.data == nullptr) {
+        for (int y = 0; y < m_height; y++) {
+            for (int x = 0; x < m_width; x++)
+                setWaveCell(x, y, -1);
+        }
+        return;
+    }
+
+    if (waveMatrix.width != m_width || waveMatrix.height != m_height)
+        resize(waveMatrix.width, waveMatrix.height);
+
+    for (int y = 0; y < waveMatrix.height; y++) {
+        const int* row = waveMatrix[y];
+        const int* shown = &m_waveSteps[(size_t)y * m_width];
+        // most rows don't change between two steps
+        if (std::equal(row, row + m_width, shown))
+            continue;
+
+        for (int x = 0; x < waveMatrix.width; x++)
+            setWaveCell(x, y, row[x]);
+    }
+}
+
+void GridRenderer::updatePath(std::span<const std::pair<int, int>> path) {
+    if (std::equal(path.begin(), path.end(), m_path.begin(), m_path.end()))
+        return;
+
+    m_path.assign(path.begin(), path.end());
+    m_pathVertices.resize(m_path.size() * 4);
+    for (size_t i = 0; i < m_path.size(); i++) {
+        placeQuad(m_pathVertices, i, tilePosition(m_path[i].first, m_path[i].second));
+        colourQuad(m_pathVertices, i, m_pathColor);
+    }
+}
+
+int GridRenderer::takeRewrittenQuads() {
+    int rewritten = m_rewrittenQuads;
+    m_rewrittenQuads = 0;
+    return rewritten;
+}
+
+void GridRenderer::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+    target.draw(m_waveVertices, states);
+    target.draw(m_mapVertices, states);
+    target.draw(m_pathVertices, states);
+
+    if (!m_showIndex || !m_fontLoaded)
+        return;
+
+    for (int y = 0; y < m_height; y++) {
+        for (int x = 0; x < m_width; x++) {
+            int step = m_waveSteps[(size_t)y * m_width + x];
+            if (step == -1)
+                continue;
+
+            sf::Vector2f position = tilePosition(x, y);
+            m_indexText.setString(std::to_string(step));
+            m_indexText.setPosition(sf::Vector2f(position.x + 5, position.y - 5));
+            target.draw(m_indexText, states);
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,88 @@
+#ifndef __GRID_RENDERER_H__
+#define __GRID_RENDERER_H__
+#include <SFML/Graphics.hpp>
+#include "PathFinder.h"
+#include <vector>
+#include <string>
+#include <span>
+
+/*
+batched grid renderer for the visualizers
+the map, the wave and the path are one sf::VertexArray of quads each, so a frame costs three draw
+calls however large the map is. The quads of the map and the wave are placed once by resize(),
+an update compares every cell with what its quad shows and recolours only the cells that changed -
+after a processStep() those are the cells of the new wave level.
+building the vertices needs no window, so they can be checked headless through getMapVertices() and friends.
+
+GridRenderer renderer(Vector2f(30, 30), Vector2f(2, 2), Vector2f(100, 100));
+renderer.updateMap(algorithm.getMapView());
+renderer.updateWave(algorithm.getWaveMatrixView());
+renderer.updatePath(algorithm.getFinalPathView());
+window.draw(renderer);
+*/
+class GridRenderer : public sf::Drawable {
+public:
+	GridRenderer(sf::Vector2f tileSize, sf::Vector2f spacing, sf::Vector2f offset);
+
+	// lays out the quads of a width x height grid, every cell starts transparent and unlabelled
+	void resize(int width, int height);
+	int getWidth() const { return m_width; }
+	int getHeight() const { return m_height; }
+
+	// wave cells fade from "from" at step 0 to "to" at step "steps" and stay "to" beyond it
+	void setWaveGradient(sf::Color from, sf::Color to, int steps);
+	void setPathColor(sf::Color color);
+	// the font is loaded once and shared by every step number drawn with setShowIndex()
+	bool setFont(const std::string& fileName);
+	void setShowIndex(bool showIndex) { m_showIndex = showIndex; }
+
+	// single cells, a cell that already shows the value keeps its quad untouched
+	void setMapCell(int x, int y, sf::Color color);
+	// step -1 clears the cell
+	void setWaveCell(int x, int y, int step);
+
+	// whole layers straight from PathFinder, a grid of another size resizes the renderer first
+	void updateMap(PathFinder::GridView<PathFinder::MapCell> map);
+	void updateWave(PathFinder::GridView<int> waveMatrix);
+	// the path layer is rebuilt only if the path differs from the one shown
+	void updatePath(std::span<const std::pair<int, int>> path);
+
+	const sf::VertexArray& getMapVertices() const { return m_mapVertices; }
+	const sf::VertexArray& getWaveVertices() const { return m_waveVertices; }
+	const sf::VertexArray& getPathVertices() const { return m_pathVertices; }
+	// quads rewritten since the last call
+	int takeRewrittenQuads();
+protected:
+	void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+private:
+	sf::Vector2f tilePosition(int x, int y) const;
+	void placeQuad(sf::VertexArray& vertices, size_t quad, sf::Vector2f position);
+	void colourQuad(sf::VertexArray& vertices, size_t quad, sf::Color color);
+	sf::Color waveColor(int step) const;
+
+	sf::Vector2f m_tileSize;
+	sf::Vector2f m_spacing;
+	sf::Vector2f m_offset;
+	int m_width, m_height;
+
+	sf::VertexArray m_mapVertices;
+	sf::VertexArray m_waveVertices;
+	sf::VertexArray m_pathVertices;
+	// the step every wave quad shows, -1 for unlabelled cells
+	std::vector<int> m_waveSteps;
+	std::vector<std::pair<int, int>> m_path;
+
+	sf::Color m_waveFrom, m_waveTo;
+	int m_waveGradientSteps;
+	sf::Color m_pathColor;
+
+	sf::Font m_font;
+	bool m_fontLoaded;
+	bool m_showIndex;
+	// one text reused for every step number
+	mutable sf::Text m_indexText;
+
+	int m_rewrittenQuads;
+};
+
+#endif //!__GRID_RENDERER_H__
\ No newline at end of file
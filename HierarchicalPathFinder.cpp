@@ -0,0 +1,319 @@
+#include "HierarchicalPathFinder.h"
+#include <queue>
+#include <functional>
+#include <algorithm>
+
+// open border stretches up to this length get one entrance in the middle, longer ones one at each end
+static const int MAX_SINGLE_ENTRANCE = 6;
+
+HierarchicalPathFinder::HierarchicalPathFinder() {
+    m_width = m_height = 0;
+    m_clusterSize = 32;
+    m_clustersX = m_clustersY = 0;
+    m_needsRebuild = false;
+    m_rebuiltClusters = 0;
+}
+
+void HierarchicalPathFinder::setMap(const PathFinder::Map& map, int clusterSize) {
+    if (map.empty() || map[0].empty() || clusterSize < 1)
+        return;
+
+    m_width = (int)map[0].size();
+    m_height = (int)map.size();
+    m_map.assign((size_t)m_width * m_height, PathFinder::MapCell::WALL);
+    for (int y = 0; y < m_height; y++) {
+        if ((int)map[y].size() != m_width)
+            return;
+        std::copy(map[y].begin(), map[y].end(), m_map.begin() + (size_t)y * m_width);
+    }
+
+    m_clusterSize = clusterSize;
+    m_clustersX = (m_width + clusterSize - 1) / clusterSize;
+    m_clustersY = (m_height + clusterSize - 1) / clusterSize;
+
+    m_clusters.clear();
+    for (int cy = 0; cy < m_clustersY; cy++) {
+        for (int cx = 0; cx < m_clustersX; cx++) {
+            Cluster cluster;
+            cluster.x = cx * clusterSize;
+            cluster.y = cy * clusterSize;
+            cluster.width = std::min(clusterSize, m_width - cluster.x);
+            cluster.height = std::min(clusterSize, m_height - cluster.y);
+            cluster.dirty = true;
+            m_clusters.push_back(cluster);
+        }
+    }
+    m_needsRebuild = true;
+}
+
+void HierarchicalPathFinder::setCell(int x, int y, PathFinder::MapCell cell) {
+    if (!isInside(x, y))
+        return;
+
+    PathFinder::MapCell& mapCell = m_map[(size_t)y * m_width + x];
+    if ((mapCell == PathFinder::MapCell::WALL) == (cell == PathFinder::MapCell::WALL)) {
+        mapCell = cell;
+        return;
+    }
+    mapCell = cell;
+
+    // a cell on a cluster edge also changes the entrances of the cluster across that edge
+    int cx = x / m_clusterSize, cy = y / m_clusterSize;
+    m_clusters[clusterAt(x, y)].dirty = true;
+    if (x % m_clusterSize == 0 && cx > 0)
+        m_clusters[clusterAt(x - 1, y)].dirty = true;
+    if (x % m_clusterSize == m_clusterSize - 1 && cx < m_clustersX - 1)
+        m_clusters[clusterAt(x + 1, y)].dirty = true;
+    if (y % m_clusterSize == 0 && cy > 0)
+        m_clusters[clusterAt(x, y - 1)].dirty = true;
+    if (y % m_clusterSize == m_clusterSize - 1 && cy < m_clustersY - 1)
+        m_clusters[clusterAt(x, y + 1)].dirty = true;
+    m_needsRebuild = true;
+}
+
+int HierarchicalPathFinder::getNode(int cluster, int x, int y) {
+    for (int node : m_clusters[cluster].nodes) {
+        if (m_nodes[node].x == x && m_nodes[node].y == y)
+            return node;
+    }
+    m_nodes.push_back({ x, y, cluster, {} });
+    m_clusters[cluster].nodes.push_back((int)m_nodes.size() - 1);
+    return (int)m_nodes.size() - 1;
+}
+
+// walks a border of "length" cells starting at (ax, ay) of cluster A, (dx, dy) points into cluster B
+void HierarchicalPathFinder::addEntrances(int clusterA, int clusterB, int ax, int ay, int dx, int dy, int length) {
+    // step along the border
+    const int sx = dy != 0 ? 1 : 0, sy = dx != 0 ? 1 : 0;
+
+    auto connect = [&](int i) {
+        int x = ax + sx * i, y = ay + sy * i;
+        int a = getNode(clusterA, x, y);
+        int b = getNode(clusterB, x + dx, y + dy);
+        m_nodes[a].neighbours.push_back(b);
+        m_nodes[b].neighbours.push_back(a);
+    };
+
+    int runStart = -1;
+    for (int i = 0; i <= length; i++) {
+        bool open = i < length && isFree(ax + sx * i, ay + sy * i) && isFree(ax + sx * i + dx, ay + sy * i + dy);
+        if (open && runStart == -1)
+            runStart = i;
+        if (open || runStart == -1)
+            continue;
+
+        int runLength = i - runStart;
+        if (runLength <= MAX_SINGLE_ENTRANCE) {
+            connect(runStart + runLength / 2);
+        }
+        else {
+            connect(runStart);
+            connect(i - 1);
+        }
+        runStart = -1;
+    }
+}
+
+void HierarchicalPathFinder::rebuild() {
+    if (!m_needsRebuild)
+        return;
+
+    // entrances are cheap to find again, and the same borders always give the same nodes in the same
+    // order, so the distance tables of clean clusters stay valid
+    m_nodes.clear();
+    for (Cluster& cluster : m_clusters)
+        cluster.nodes.clear();
+
+    for (int cy = 0; cy < m_clustersY; cy++) {
+        for (int cx = 0; cx < m_clustersX; cx++) {
+            int index = cy * m_clustersX + cx;
+            const Cluster& cluster = m_clusters[index];
+            if (cx < m_clustersX - 1)
+                addEntrances(index, index + 1, cluster.x + cluster.width - 1, cluster.y, 1, 0, cluster.height);
+            if (cy < m_clustersY - 1)
+                addEntrances(index, index + m_clustersX, cluster.x, cluster.y + cluster.height - 1, 0, 1, cluster.width);
+        }
+    }
+
+    m_rebuiltClusters = 0;
+    for (Cluster& cluster : m_clusters) {
+        if (!cluster.dirty)
+            continue;
+        computeDistances(cluster);
+        cluster.dirty = false;
+        m_rebuiltClusters++;
+    }
+    m_needsRebuild = false;
+}
+
+void HierarchicalPathFinder::loadCluster(const Cluster& cluster) {
+    std::vector<PathFinder::MapCell> cells((size_t)cluster.width * cluster.height);
+    for (int row = 0; row < cluster.height; row++) {
+        auto source = m_map.begin() + (size_t)(cluster.y + row) * m_width + cluster.x;
+        std::copy(source, source + cluster.width, cells.begin() + (size_t)row * cluster.width);
+    }
+    for (PathFinder::MapCell& cell : cells) {
+        if (cell != PathFinder::MapCell::WALL)
+            cell = PathFinder::MapCell::EMPTY;
+    }
+
+    m_localSearch.setMap(cells, cluster.width);
+}
+
+void HierarchicalPathFinder::floodCluster(const Cluster& cluster, int x, int y) {
+    m_localSearch.setEndpoints(x - cluster.x, y - cluster.y, x - cluster.x, y - cluster.y);
+    m_localSearch.processAll();
+}
+
+void HierarchicalPathFinder::computeDistances(Cluster& cluster) {
+    const size_t count = cluster.nodes.size();
+    cluster.distances.assign(count * count, -1);
+
+    if (count == 0)
+        return;
+
+    loadCluster(cluster);
+    for (size_t i = 0; i < count; i++) {
+        const Node& from = m_nodes[cluster.nodes[i]];
+        floodCluster(cluster, from.x, from.y);
+        for (size_t j = 0; j < count; j++) {
+            const Node& to = m_nodes[cluster.nodes[j]];
+            cluster.distances[i * count + j] = m_localSearch.distanceTo(to.x - cluster.x, to.y - cluster.y);
+        }
+    }
+}
+
+std::vector<std::pair<int, int>> HierarchicalPathFinder::findAbstractPath(int startX, int startY, int endX, int endY) {
+    std::vector<std::pair<int, int>> waypoints;
+    if (!isInside(startX, startY) || !isInside(endX, endY) || !isFree(startX, startY) || !isFree(endX, endY))
+        return waypoints;
+
+    rebuild();
+
+    // START and END join the graph as two extra nodes linked to the entrances of their clusters
+    const int nodeCount = (int)m_nodes.size();
+    const int startNode = nodeCount, endNode = nodeCount + 1;
+    std::vector<std::pair<int, int>> startEdges, endEdges; // node, cost
+    int directCost = -1;
+
+    const Cluster& startCluster = m_clusters[clusterAt(startX, startY)];
+    loadCluster(startCluster);
+    floodCluster(startCluster, startX, startY);
+    for (int node : startCluster.nodes) {
+        int cost = m_localSearch.distanceTo(m_nodes[node].x - startCluster.x, m_nodes[node].y - startCluster.y);
+        if (cost != -1)
+            startEdges.push_back({ node, cost });
+    }
+    if (clusterAt(startX, startY) == clusterAt(endX, endY))
+        directCost = m_localSearch.distanceTo(endX - startCluster.x, endY - startCluster.y);
+
+    const Cluster& endCluster = m_clusters[clusterAt(endX, endY)];
+    loadCluster(endCluster);
+    floodCluster(endCluster, endX, endY);
+    for (int node : endCluster.nodes) {
+        int cost = m_localSearch.distanceTo(m_nodes[node].x - endCluster.x, m_nodes[node].y - endCluster.y);
+        if (cost != -1)
+            endEdges.push_back({ node, cost });
+    }
+
+    // dijkstra over the entrance graph
+    std::vector<int> distance(nodeCount + 2, -1), previous(nodeCount + 2, -1);
+    typedef std::pair<int, int> QueueEntry; // distance, node
+    std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> queue;
+
+    auto relax = [&](int node, int from, int cost) {
+        if (distance[node] == -1 || cost < distance[node]) {
+            distance[node] = cost;
+            previous[node] = from;
+            queue.push({ cost, node });
+        }
+    };
+
+    distance[startNode] = 0;
+    for (auto [node, cost] : startEdges)
+        relax(node, startNode, cost);
+    if (directCost != -1)
+        relax(endNode, startNode, directCost);
+
+    std::vector<int> endCost(nodeCount, -1);
+    for (auto [node, cost] : endEdges)
+        endCost[node] = cost;
+
+    while (!queue.empty()) {
+        auto [cost, node] = queue.top();
+        queue.pop();
+        if (cost != distance[node])
+            continue;
+        if (node == endNode)
+            break;
+
+        if (endCost[node] != -1)
+            relax(endNode, node, cost + endCost[node]);
+        for (int neighbour : m_nodes[node].neighbours)
+            relax(neighbour, node, cost + 1);
+
+        const Cluster& cluster = m_clusters[m_nodes[node].cluster];
+        const size_t count = cluster.nodes.size();
+        size_t local = std::find(cluster.nodes.begin(), cluster.nodes.end(), node) - cluster.nodes.begin();
+        for (size_t j = 0; j < count; j++) {
+            int step = cluster.distances[local * count + j];
+            if (step > 0)
+                relax(cluster.nodes[j], node, cost + step);
+        }
+    }
+
+    if (distance[endNode] == -1)
+        return waypoints;
+
+    for (int node = endNode; node != -1; node = previous[node]) {
+        if (node == startNode)
+            waypoints.push_back({ startX, startY });
+        else if (node == endNode)
+            waypoints.push_back({ endX, endY });
+        else
+            waypoints.push_back({ m_nodes[node].x, m_nodes[node].y });
+    }
+    std::reverse(waypoints.begin(), waypoints.end());
+    return waypoints;
+}
+
+std::vector<std::pair<int, int>> HierarchicalPathFinder::refineSegment(int fromX, int fromY, int toX, int toY) {
+    std::vector<std::pair<int, int>> segment;
+    if (!isInside(fromX, fromY) || !isInside(toX, toY))
+        return segment;
+
+    // entrances across a border are direct neighbours
+    if (std::abs(fromX - toX) + std::abs(fromY - toY) <= 1) {
+        if (fromX != toX || fromY != toY)
+            segment.push_back({ toX, toY });
+        return segment;
+    }
+
+    rebuild();
+    const Cluster& cluster = m_clusters[clusterAt(fromX, fromY)];
+    if (clusterAt(toX, toY) != clusterAt(fromX, fromY))
+        return segment;
+
+    loadCluster(cluster);
+    m_localSearch.setEndpoints(fromX - cluster.x, fromY - cluster.y, toX - cluster.x, toY - cluster.y);
+    m_localSearch.process();
+    std::vector<std::pair<int, int>> path = m_localSearch.getFinalPath();
+    for (size_t i = 1; i < path.size(); i++)
+        segment.push_back({ path[i].first + cluster.x, path[i].second + cluster.y });
+    return segment;
+}
+
+std::vector<std::pair<int, int>> HierarchicalPathFinder::findPath(int startX, int startY, int endX, int endY) {
+    std::vector<std::pair<int, int>> waypoints = findAbstractPath(startX, startY, endX, endY);
+    std::vector<std::pair<int, int>> path;
+    if (waypoints.empty())
+        return path;
+
+    path.push_back(waypoints[0]);
+    for (size_t i = 1; i < waypoints.size(); i++) {
+        std::vector<std::pair<int, int>> segment = refineSegment(waypoints[i - 1].first, waypoints[i - 1].second,
+            waypoints[i].first, waypoints[i].second);
+        path.insert(path.end(), segment.begin(), segment.end());
+    }
+    return path;
+}
\ No newline at end of file
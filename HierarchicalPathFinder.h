@@ -0,0 +1,79 @@
+#ifndef __HIERARCHICAL_PATH_FINDER_H__
+#define __HIERARCHICAL_PATH_FINDER_H__
+#include "PathFinder.h"
+#include <vector>
+
+/*
+hierarchical path finding (HPA*) for large maps
+the grid is split into square clusters. Entrances are placed on every open stretch of a
+cluster border and the distances between the entrances of a cluster are precomputed with the
+wave algorithm. A query searches the small graph of entrances and refines only the segments
+of the abstract path into cells. Paths are near optimal: inside a cluster they never leave it.
+
+HierarchicalPathFinder hpa;
+hpa.setMap(map, 32);
+std::vector<std::pair<int, int>> path = hpa.findPath(startX, startY, endX, endY);
+*/
+class HierarchicalPathFinder {
+public:
+	HierarchicalPathFinder();
+
+	void setMap(const PathFinder::Map& map, int clusterSize = 32);
+
+	// only clusters touched by edits are recomputed, lazily on the next query
+	void setCell(int x, int y, PathFinder::MapCell cell);
+
+	// cells of the path from start to end, empty if there is none
+	std::vector<std::pair<int, int>> findPath(int startX, int startY, int endX, int endY);
+	// waypoints of the abstract path, consecutive waypoints share a cluster or are neighbours
+	std::vector<std::pair<int, int>> findAbstractPath(int startX, int startY, int endX, int endY);
+	// cells from one waypoint to the next one, without the first waypoint
+	std::vector<std::pair<int, int>> refineSegment(int fromX, int fromY, int toX, int toY);
+
+	int getClusterCount() { return (int)m_clusters.size(); }
+	int getEntranceCount() { return (int)m_nodes.size(); }
+	// clusters whose entrance distances were computed by the last rebuild
+	int getRebuiltClusterCount() { return m_rebuiltClusters; }
+protected:
+	struct Cluster {
+		int x, y, width, height;
+		std::vector<int> nodes;
+		// entrance to entrance wave steps, nodes.size() x nodes.size(), -1 if not connected
+		std::vector<int> distances;
+		bool dirty;
+	};
+
+	struct Node {
+		int x, y;
+		int cluster;
+		// entrance nodes on the other side of a cluster border
+		std::vector<int> neighbours;
+	};
+
+	void rebuild();
+	void addEntrances(int clusterA, int clusterB, int ax, int ay, int dx, int dy, int length);
+	int getNode(int cluster, int x, int y);
+	void computeDistances(Cluster& cluster);
+	// loads the cluster region into m_localSearch
+	void loadCluster(const Cluster& cluster);
+	// labels the loaded cluster from the map cell (x, y)
+	void floodCluster(const Cluster& cluster, int x, int y);
+
+	int clusterAt(int x, int y) const { return (y / m_clusterSize) * m_clustersX + x / m_clusterSize; }
+	bool isFree(int x, int y) const { return m_map[(size_t)y * m_width + x] != PathFinder::MapCell::WALL; }
+	bool isInside(int x, int y) const { return x >= 0 && y >= 0 && x < m_width && y < m_height; }
+
+	std::vector<PathFinder::MapCell> m_map;
+	int m_width, m_height;
+	int m_clusterSize;
+	int m_clustersX, m_clustersY;
+
+	std::vector<Cluster> m_clusters;
+	std::vector<Node> m_nodes;
+	bool m_needsRebuild;
+	int m_rebuiltClusters;
+
+	PathFinder m_localSearch;
+};
+
+#endif //!__HIERARCHICAL_PATH_FINDER_H__
\ No newline at end of file
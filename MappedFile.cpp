@@ -0,0 +1,107 @@
+#include "MappedFile.h"
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile() {
+    m_data = nullptr;
+    m_size = 0;
+    m_isEmptyFile = false;
+    m_copyOnWrite = false;
+#if defined(_WIN32)
+    m_file = INVALID_HANDLE_VALUE;
+    m_mapping = nullptr;
+#endif
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::open(const std::string& fileName, bool copyOnWrite) {
+    close();
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        return false;
+    }
+    m_file = file;
+    if (size.QuadPart == 0) {
+        m_isEmptyFile = true;
+        return true;
+    }
+
+    m_mapping = CreateFileMappingA(file, nullptr, copyOnWrite ? PAGE_WRITECOPY : PAGE_READONLY, 0, 0, nullptr);
+    if (!m_mapping) {
+        close();
+        return false;
+    }
+    m_data = (char*)MapViewOfFile(m_mapping, copyOnWrite ? FILE_MAP_COPY : FILE_MAP_READ, 0, 0, 0);
+    if (!m_data) {
+        close();
+        return false;
+    }
+    m_size = (size_t)size.QuadPart;
+#else
+    int file = ::open(fileName.c_str(), O_RDONLY);
+    if (file == -1)
+        return false;
+
+    struct stat info;
+    if (fstat(file, &info) != 0) {
+        ::close(file);
+        return false;
+    }
+    if (info.st_size == 0) {
+        ::close(file);
+        m_isEmptyFile = true;
+        return true;
+    }
+
+    int protection = copyOnWrite ? PROT_READ | PROT_WRITE : PROT_READ;
+    void* data = mmap(nullptr, (size_t)info.st_size, protection, MAP_PRIVATE, file, 0);
+    // the mapping keeps its own reference to the file
+    ::close(file);
+    if (data == MAP_FAILED)
+        return false;
+
+    // read-only files are parsed front to back, writable ones are searched
+    madvise(data, (size_t)info.st_size, copyOnWrite ? MADV_WILLNEED : MADV_SEQUENTIAL);
+    m_data = (char*)data;
+    m_size = (size_t)info.st_size;
+#endif
+    m_copyOnWrite = copyOnWrite;
+    return true;
+}
+
+void MappedFile::close() {
+#if defined(_WIN32)
+    if (m_data)
+        UnmapViewOfFile(m_data);
+    if (m_mapping)
+        CloseHandle(m_mapping);
+    if (m_file != INVALID_HANDLE_VALUE)
+        CloseHandle(m_file);
+    m_mapping = nullptr;
+    m_file = INVALID_HANDLE_VALUE;
+#else
+    if (m_data)
+        munmap(m_data, m_size);
+#endif
+    m_data = nullptr;
+    m_size = 0;
+    m_isEmptyFile = false;
+    m_copyOnWrite = false;
+}
\ No newline at end of file
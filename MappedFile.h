@@ -0,0 +1,39 @@
+#ifndef __MAPPED_FILE_H__
+#define __MAPPED_FILE_H__
+#include <string>
+#include <cstddef>
+
+/*
+read-only memory mapping of a whole file, unmapped in the destructor or by close().
+an empty file opens fine with getData() == nullptr and getSize() == 0.
+with copyOnWrite the pages may be written, the first write to a page gives the process
+a private copy of it and the file stays unchanged.
+*/
+class MappedFile {
+public:
+	MappedFile();
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	bool open(const std::string& fileName, bool copyOnWrite = false);
+	void close();
+
+	const char* getData() const { return m_data; }
+	// nullptr unless the file was opened with copyOnWrite
+	char* getWritableData() { return m_copyOnWrite ? m_data : nullptr; }
+	size_t getSize() const { return m_size; }
+	bool isOpen() const { return m_data != nullptr || m_isEmptyFile; }
+private:
+	char* m_data;
+	size_t m_size;
+	bool m_isEmptyFile;
+	bool m_copyOnWrite;
+#if defined(_WIN32)
+	void* m_file;
+	void* m_mapping;
+#endif
+};
+
+#endif //!__MAPPED_FILE_H__
\ No newline at end of file
@@ -0,0 +1,62 @@
+#include "PathBatch.h"
+#include <chrono>
+
+PathBatch::PathBatch(int threadCount) : m_threadPool(threadCount) {
+    m_searchMode = PathFinder::SearchMode::WAVE;
+    for (int i = 0; i < m_threadPool.getThreadCount(); i++)
+        m_workers.push_back(std::make_unique<PathFinder>());
+}
+
+PathBatch::Result PathBatch::process(const PathFinder::Map& map, const std::vector<Query>& queries) {
+    return process(SharedMap::create(map), queries);
+}
+
+PathBatch::Result PathBatch::process(std::shared_ptr<const SharedMap> map, const std::vector<Query>& queries) {
+    auto startTime = std::chrono::steady_clock::now();
+
+    Result result;
+    result.results.resize(queries.size());
+    result.found = result.unreachable = result.invalid = 0;
+
+    PathFinder::SearchMode mode = m_searchMode;
+    if (mode == PathFinder::SearchMode::PARALLEL)
+        mode = PathFinder::SearchMode::WAVE;
+
+    // the workers only point at the shared map, nothing is copied
+    bool newMap = map != m_map;
+    m_map = map;
+    m_threadPool.run([&](int worker) {
+        PathFinder& pathFinder = *m_workers[worker];
+        if (newMap)
+            pathFinder.setMap(map);
+        if (pathFinder.getSearchMode() != mode)
+            pathFinder.setSearchMode(mode);
+    });
+
+    m_threadPool.runTasks((int)queries.size(), [&](int worker, int queryIndex) {
+        PathFinder& pathFinder = *m_workers[worker];
+        const Query& query = queries[queryIndex];
+        QueryResult& queryResult = result.results[queryIndex];
+
+        if (!pathFinder.setEndpoints(query.startX, query.startY, query.endX, query.endY)) {
+            queryResult.status = Status::INVALID;
+            return;
+        }
+
+        pathFinder.process();
+        queryResult.status = pathFinder.isPointReached() ? Status::FOUND : Status::UNREACHABLE;
+        queryResult.path = pathFinder.getFinalPath();
+    });
+
+    for (const QueryResult& queryResult : result.results) {
+        switch (queryResult.status) {
+        case Status::FOUND: result.found++; break;
+        case Status::UNREACHABLE: result.unreachable++; break;
+        case Status::INVALID: result.invalid++; break;
+        }
+    }
+
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    result.queriesPerSecond = result.seconds > 0.0 ? queries.size() / result.seconds : 0.0;
+    return result;
+}
\ No newline at end of file
@@ -0,0 +1,61 @@
+#ifndef __PATH_BATCH_H__
+#define __PATH_BATCH_H__
+#include "PathFinder.h"
+#include "SharedMap.h"
+#include "ThreadPool.h"
+#include <vector>
+#include <memory>
+
+/*
+answers many START -> END queries on one map at once.
+queries are spread over a work-stealing thread pool, every worker keeps one PathFinder
+whose buffers are reused for all of its queries (and for later batches).
+all workers search one SharedMap, the map is held once however many threads there are.
+
+PathBatch batch;
+PathBatch::Result result = batch.process(map, { {1, 2, 6, 5}, {3, 1, 12, 6} });
+*/
+class PathBatch {
+public:
+	struct Query {
+		int startX, startY, endX, endY;
+	};
+
+	enum class Status {
+		FOUND,
+		UNREACHABLE,
+		INVALID		// a point lies outside of the map
+	};
+
+	struct QueryResult {
+		Status status;
+		std::vector<std::pair<int, int>> path;
+	};
+
+	struct Result {
+		std::vector<QueryResult> results;	// in the order of the queries
+		int found;
+		int unreachable;
+		int invalid;
+		double seconds;
+		double queriesPerSecond;
+	};
+
+	// threadCount < 1 uses all hardware threads
+	explicit PathBatch(int threadCount = 0);
+
+	// SearchMode::PARALLEL is replaced by WAVE, the batch is already spread over the threads
+	void setSearchMode(PathFinder::SearchMode mode) { m_searchMode = mode; }
+
+	Result process(const PathFinder::Map& map, const std::vector<Query>& queries);
+	// batches on the same shared map skip loading it into the workers
+	Result process(std::shared_ptr<const SharedMap> map, const std::vector<Query>& queries);
+private:
+	ThreadPool m_threadPool;
+	std::vector<std::unique_ptr<PathFinder>> m_workers;
+	PathFinder::SearchMode m_searchMode;
+	// the map the workers are bound to
+	std::shared_ptr<const SharedMap> m_map;
+};
+
+#endif //!__PATH_BATCH_H__
\ No newline at end of file
@@ -1,218 +1,436 @@
 #include "PathFinder.h"
-#include <cctype>
+#include "ThreadPool.h"
+#include "MappedFile.h"
+#include <algorithm>
 
 PathFinder::PathFinder() {
-    m_map = {};
+    m_map = nullptr;
+    m_mapSize = 0;
     m_waveMatrix = {};
+    m_waveStorage = WaveStorage::DENSE;
+    m_pagesTracked = false;
     m_waveStep = -1;
+    m_waveCursor = 0;
+    m_mapWidth = m_mapHeight = 0;
+    m_stride = 2;
     m_startX = m_startY = m_endX = m_endY = 0;
     m_reachedPoint = false;
+    m_searchMode = SearchMode::WAVE;
+    m_neighbourhood = Neighbourhood::FOUR;
+    m_bitTilesX = 0;
+    m_tileStamp = 0;
+    m_backWaveStep = 0;
+    m_meetIndex = -1;
+    m_bitFrontierCells = 0;
+    m_syncStep = 0;
+    m_threadCount = 0;
+    m_unvisitedCells = 0;
+    m_floodAll = m_flooded = false;
+    m_bucketMask = 0;
+    m_currentF = 0;
+    m_openCount = 0;
+    m_cancelRequested = false;
+    m_flowOffset = 0;
+    m_flowGoal = -1;
+    resetStats();
+}
+
+PathFinder::~PathFinder() {
+    cancel();
+}
+
+// points the search at the owned grid and drops a mapped binary map
+void PathFinder::useMapStorage() {
+    m_map = m_mapStorage.data();
+    m_mapSize = m_mapStorage.size();
+    m_mappedFile.reset();
+    m_sharedMap.reset();
+    m_costs.clear();
+    m_flowGoal = -1;
+    m_components.clear();
+    m_landmarks.clear();
+    m_landmarkTable.clear();
+    m_jumpRight.clear();
+    m_jumpLeft.clear();
+    m_freeBits.clear();
 }
 
 void PathFinder::log(std::string logString) {
 #if defined(_MSC_VER)
-	printf("[PathFinder log message] %s\n", logString.c_str());
+    printf("[PathFinder log message] %s\n", logString.c_str());
+#else
+    (void)logString;
 #endif
 }
 
-void PathFinder::setMap(PathFinder::Map newMap) {
-	if (newMap.empty())
-		return;
-
-	int height = newMap.size();
-	int width = newMap[0].size();
-
-	if (width < 1)
-		return;
-	
-	for (int i = 0; i < newMap.size(); i++) {
-        std::vector<MapCell>& row = newMap[i];
-		if (width != row.size()) {
-			log("matrix have different width");
-			return;
-		}
-
-        for (int j = 0; j < width; j++) {
-            MapCell cell = row[j];
-
-            if (cell == MapCell::START) {
-                m_startX = j;
-                m_startY = i;
-            }
-            else if (cell == MapCell::END) {
-                m_endX = j;
-                m_endY = i;
-            }
+void PathFinder::allocateMap(int width, int height) {
+    m_mapWidth = width;
+    m_mapHeight = height;
+    m_stride = width + 2;
+    m_mapStorage.assign((size_t)m_stride * (height + 2), MapCell::WALL);
+    useMapStorage();
+    m_startX = m_startY = m_endX = m_endY = 0;
+}
+
+void PathFinder::storeCell(int x, int y, MapCell cell) {
+    m_map[cellIndex(x, y)] = cell;
+
+    if (cell == MapCell::START) {
+        m_startX = x;
+        m_startY = y;
+    }
+    else if (cell == MapCell::END) {
+        m_endX = x;
+        m_endY = y;
+    }
+}
+
+void PathFinder::setMap(const PathFinder::Map& newMap) {
+    if (newMap.empty())
+        return;
+
+    int height = newMap.size();
+    int width = newMap[0].size();
+
+    if (width < 1)
+        return;
+
+    for (size_t i = 0; i < newMap.size(); i++) {
+        if ((size_t)width != newMap[i].size()) {
+            log("matrix have different width");
+            return;
         }
-	}
+    }
 
-	m_map = newMap;
-	m_mapWidth = width;
-	m_mapHeight = height;
+    allocateMap(width, height);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++)
+            storeCell(x, y, newMap[y][x]);
+    }
     reset();
 }
 
-/*
-string map data parser
-write maps in format:
-0,0,0,0,0,0
-0,0,1,0,0,0
-0,0,0,1,0,0
-0,0,0,0,1,0
-0,0,0,0,0,0
-
-EMPTY = 0
-WALL = 1
-START = 2
-END = 3
-*/
-void PathFinder::setMap(std::string map) {
-    Map newMap = {};
-    std::vector<MapCell> row = {};
-    std::string cellStr = "";
-    for (int i = 0; i < map.length(); i++) {
-        bool isDigit = std::isdigit(map[i]);
-        if (isDigit) {
-            cellStr += map[i];
-        }
-        else if (map[i] == ',' || map[i] == '\n') {
-            try {
-                if (!cellStr.empty()) {
-                    //log("setMap(string): passing a string [" + cellStr + "]");
-                    row.push_back((MapCell)(std::stoi(cellStr)));
-                }
-            }
-            catch (std::exception e) {
-                log(std::string("setMap(string): " + std::string(e.what())));
-            }
-
-            if (map[i] == '\n') {
-                if (!row.empty())
-                    newMap.push_back(row);
-                row = {};
-            }
-
-            cellStr = "";
+void PathFinder::setMap(const std::vector<MapCell>& newMap, int cols) {
+    if (newMap.empty() || cols < 1)
+        return;
+
+    if (newMap.size() % cols != 0) {
+        log("map size is not a multiple of cols");
+        return;
+    }
+
+    int height = newMap.size() / cols;
+    allocateMap(cols, height);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < cols; x++)
+            storeCell(x, y, newMap[(size_t)y * cols + x]);
+    }
+    reset();
+}
+
+bool PathFinder::setEndpoints(int startX, int startY, int endX, int endY) {
+    auto isInside = [this](int x, int y) { return x >= 0 && y >= 0 && x < m_mapWidth && y < m_mapHeight; };
+    if (!isInside(startX, startY) || !isInside(endX, endY))
+        return false;
+
+    // markers move with the points, walls stay walls. A shared map is never written
+    auto moveMarker = [this](MapCell marker, int oldIndex, int newIndex) {
+        if (m_map[oldIndex] == marker)
+            m_map[oldIndex] = MapCell::EMPTY;
+        if (m_map[newIndex] == MapCell::EMPTY)
+            m_map[newIndex] = marker;
+    };
+    if (!m_sharedMap) {
+        moveMarker(MapCell::START, cellIndex(m_startX, m_startY), cellIndex(startX, startY));
+        moveMarker(MapCell::END, cellIndex(m_endX, m_endY), cellIndex(endX, endY));
+    }
+
+    m_startX = startX;
+    m_startY = startY;
+    m_endX = endX;
+    m_endY = endY;
+    reset();
+    return true;
+}
+
+PathFinder::Map PathFinder::getMap() {
+    Map map(m_mapHeight, std::vector<MapCell>(m_mapWidth));
+    for (int y = 0; y < m_mapHeight; y++) {
+        const MapCell* row = &m_map[cellIndex(0, y)];
+        std::copy(row, row + m_mapWidth, map[y].begin());
+    }
+    return map;
+}
+
+std::vector<std::vector<int>> PathFinder::getWaveMatrix() {
+    std::vector<std::vector<int>> waveMatrix(m_mapHeight, std::vector<int>(m_mapWidth));
+    if (m_waveStorage == WaveStorage::PAGED) {
+        for (int y = 0; y < m_mapHeight; y++) {
+            for (int x = 0; x < m_mapWidth; x++)
+                waveMatrix[y][x] = waveStep(cellIndex(x, y));
         }
+        return waveMatrix;
+    }
+    syncBitboardWave();
+    if (m_waveMatrix.empty())
+        return waveMatrix;
+
+    for (int y = 0; y < m_mapHeight; y++) {
+        const int* row = &m_waveMatrix[cellIndex(0, y)];
+        std::copy(row, row + m_mapWidth, waveMatrix[y].begin());
     }
-    setMap(newMap);
+    return waveMatrix;
+}
+
+PathFinder::GridView<int> PathFinder::getWaveMatrixView() {
+    syncBitboardWave();
+    if (m_waveMatrix.empty())
+        return { nullptr, 0, 0, m_stride };
+    return { m_waveMatrix.data() + m_stride + 1, m_mapWidth, m_mapHeight, m_stride };
 }
 
 std::string PathFinder::getMapAsString() {
-    std::string dataStr = "";
-    for (int y = 0; y < m_map.size(); y++) {
-        for (int x = 0; x < m_map[y].size(); x++) {
-            dataStr += std::to_string((int)m_map[y][x]);
-
-            if (x >= m_map[y].size() - 1) {
-                dataStr += '\n';
-            }
-            else {
-                dataStr += ',';
-            }
+    // every cell is one digit and a ',' or '\n', so the string is sized once and filled in place
+    std::string dataStr((size_t)m_mapWidth * m_mapHeight * 2, ',');
+    char* out = dataStr.data();
+    for (int y = 0; y < m_mapHeight; y++) {
+        const MapCell* row = &m_map[cellIndex(0, y)];
+        for (int x = 0; x < m_mapWidth; x++) {
+            *out = (char)('0' + (int)row[x]);
+            out += 2;
         }
+        out[-1] = '\n';
     }
     return dataStr;
 }
 
 void PathFinder::reset() {
-	m_waveStep = -1;
-	m_waveMatrix = std::vector<std::vector<int>>(m_mapHeight, std::vector<int>(m_mapWidth, -1));
-    m_reachedPoint = m_startX == m_endX && m_startY == m_endY;
-    m_wave = {};
-    m_finalPath = {};
-    m_oldWave = { {m_startX, m_startY} };
-    m_waveMatrix[m_startY][m_startX] = 0;
-}
-
-void PathFinder::processStep() {
-    if (m_reachedPoint || m_oldWave.empty())
+    if (m_mapSize == 0)
         return;
-    const int dirX[4] = { 0, 1, 0, -1 };
-    const int dirY[4] = { -1, 0, 1, 0 };
+#if defined(PATH_FINDER_STATS)
+    resetStats();
+#endif
 
-    int h = m_mapHeight;
-    if (h == 0) return;
-    int w = m_mapWidth;
+    m_waveStep = 0;
+    m_waveCursor = 0;
+    clearSearchCells();
+    m_reachedPoint = m_startX == m_endX && m_startY == m_endY;
+    m_flooded = false;
+    m_wave.clear();
+    m_finalPath.clear();
+    m_oldWave.clear();
+    m_oldWave.push_back(cellIndex(m_startX, m_startY));
+    if (m_waveStorage == WaveStorage::PAGED)
+        PagedWave{ this }.set(m_oldWave[0], 0);
+    else
+        DenseWave{ m_waveMatrix.data(), this }.set(m_oldWave[0], 0);
 
-    std::vector<std::pair<int,int>>& oldWave = m_oldWave;
-    std::vector<std::pair<int, int>>& wave = m_wave;
-    bool& pointReached = m_reachedPoint;
-    PathFinder::Map map = m_map;
-    std::vector<std::vector<int>>& waveMatrix = m_waveMatrix;
+    // the parallel engine labels cells without listing their pages
+    SearchMode mode = activeSearchMode();
+    m_pagesTracked = mode != SearchMode::PARALLEL;
+    m_syncWave.clear();
 
-    int nextStep = m_waveStep + 1;
-    wave.clear();
+    if (mode == SearchMode::BITBOARD)
+        resetBitboard();
+    else if (mode == SearchMode::BIDIRECTIONAL)
+        resetBidirectional();
+    else if (mode == SearchMode::PARALLEL)
+        resetParallel();
+    else if (mode == SearchMode::ASTAR || mode == SearchMode::JPS || mode == SearchMode::WEIGHTED)
+        resetHeuristic();
 
-    for (int i = 0; i < (int)oldWave.size(); i++) {
-        for (int d = 0; d < 4; d++) {
-            int newX = oldWave[i].first + dirX[d];
-            int newY = oldWave[i].second + dirY[d];
+    // START and END in different components, there is nothing to search. A START on a wall
+    // still reaches its neighbours, so it is left to the search
+    int startIndex = cellIndex(m_startX, m_startY);
+    if (!m_reachedPoint && !m_floodAll && !m_components.empty() && m_map[startIndex] != MapCell::WALL
+        && m_components[startIndex] != m_components[cellIndex(m_endX, m_endY)])
+        m_oldWave.clear();
+#if defined(PATH_FINDER_STATS)
+    recordReset();
+#endif
+}
 
-            bool isBeyondMap = newX < 0 || newY < 0 || newX >= w || newY >= h;
-            bool isOccupied = map[newY][newX] == PathFinder::MapCell::WALL;
-            bool isWasVisited = waveMatrix[newY][newX] != -1;
+void PathFinder::setSearchMode(SearchMode mode) {
+    m_searchMode = mode;
+    reset();
+}
 
-            if (isBeyondMap || isOccupied || isWasVisited)
-                continue;
+void PathFinder::setNeighbourhood(Neighbourhood neighbourhood) {
+    m_neighbourhood = neighbourhood;
+    m_flowGoal = -1;
+    m_components.clear();
+    m_landmarks.clear();
+    m_landmarkTable.clear();
+    reset();
+}
 
-            waveMatrix[newY][newX] = nextStep;
-            wave.push_back({newX, newY});
+PathFinder::SearchMode PathFinder::activeSearchMode() const {
+    SearchMode mode = m_searchMode;
+    // the other engines are written for four neighbours
+    if (m_neighbourhood != Neighbourhood::FOUR)
+        mode = SearchMode::WAVE;
+    // a full flood has no target to meet or to aim at, the forward wave alone covers it
+    // and a weighted flood is Dial's algorithm. A flood is read cell by cell afterwards,
+    // so the bitboard engine, which keeps only the steps modulo 4, leaves it to the wave too
+    // a paged wave is searched by the plain wave only
+    if (m_waveStorage == WaveStorage::PAGED)
+        return SearchMode::WAVE;
+    if (isWeighted() && (m_floodAll || mode == SearchMode::WEIGHTED))
+        mode = SearchMode::WEIGHTED;
+    else if (m_floodAll && (mode == SearchMode::BIDIRECTIONAL || mode == SearchMode::ASTAR || mode == SearchMode::JPS || mode == SearchMode::BITBOARD))
+        mode = SearchMode::WAVE;
+    // jump points assume unit steps, and without costs the weighted search is the plain wave
+    if (mode == SearchMode::JPS && isWeighted())
+        mode = SearchMode::ASTAR;
+    else if (mode == SearchMode::WEIGHTED && !isWeighted())
+        mode = SearchMode::WAVE;
+    return mode;
+}
 
-            if ((newX == m_endX && newY == m_endY)) {
-                pointReached = true;
-                break;
-            }
+void PathFinder::processStep() {
+    if (m_reachedPoint || m_oldWave.empty())
+        return;
 
-        }
-        if (pointReached)
-            break;
+    // the stats describe the engine that runs, not the mode that was asked for
+    const SearchMode mode = activeSearchMode();
+#if defined(PATH_FINDER_STATS)
+    std::chrono::steady_clock::time_point stepStart = std::chrono::steady_clock::now();
+    int frontier = (int)m_oldWave.size();
+    if (mode == SearchMode::ASTAR || mode == SearchMode::JPS || mode == SearchMode::WEIGHTED)
+        frontier = (int)m_openCount;
+    else if (mode == SearchMode::BIDIRECTIONAL)
+        frontier += (int)m_oldBackWave.size();
+    else if (mode == SearchMode::BITBOARD)
+        frontier = (int)m_bitFrontierCells;
+    int waveStepBefore = m_waveStep;
+#endif
+
+    switch (mode) {
+    case SearchMode::BITBOARD:
+        processBitboardStep();
+        break;
+    case SearchMode::BIDIRECTIONAL:
+        processBidirectionalStep();
+        break;
+    case SearchMode::PARALLEL:
+        processParallelStep();
+        break;
+    case SearchMode::ASTAR:
+        processAStarStep();
+        break;
+    case SearchMode::JPS:
+        processJumpPointStep();
+        break;
+    case SearchMode::WEIGHTED:
+        // the A* step without a heuristic, one step settles one distance
+        processAStarStep();
+        break;
+    default:
+    case SearchMode::WAVE:
+        processWaveStep();
+        break;
     }
-    m_waveStep = nextStep;
-    oldWave = wave;
+
+#if defined(PATH_FINDER_STATS)
+    // every engine leaves the cells of the step in m_oldWave, the bidirectional one may have moved the back wave instead
+    // and the bitboard one only counts them
+    int labelled = (int)m_oldWave.size();
+    if (mode == SearchMode::BIDIRECTIONAL && m_waveStep == waveStepBefore)
+        labelled = (int)m_oldBackWave.size();
+    else if (mode == SearchMode::BITBOARD)
+        labelled = (int)m_bitFrontierCells;
+    recordStep(stepStart, frontier, labelled);
+#endif
 }
 
 void PathFinder::process() {
     while (!m_oldWave.empty() && !m_reachedPoint)
         processStep();
-    m_finalPath = calculatePath();
+    calculatePath(m_finalPath);
+#if defined(PATH_FINDER_STATS)
+    recordPath(m_finalPath.size());
+#endif
+}
+
+void PathFinder::process(std::vector<std::pair<int, int>>& path) {
+    while (!m_oldWave.empty() && !m_reachedPoint)
+        processStep();
+    m_finalPath.clear();
+    calculatePath(path);
+#if defined(PATH_FINDER_STATS)
+    recordPath(path.size());
+#endif
+}
+
+void PathFinder::processAll() {
+    m_floodAll = true;
+    reset();
+    // END is not a target while flooding, reachability is read from the wave matrix afterwards
+    m_reachedPoint = false;
+    while (!m_oldWave.empty())
+        processStep();
+    m_floodAll = false;
+
+    m_flooded = true;
+    m_reachedPoint = waveStep(cellIndex(m_endX, m_endY)) != -1;
+    calculatePath(m_finalPath);
+#if defined(PATH_FINDER_STATS)
+    recordPath(m_finalPath.size());
+#endif
+}
+
+int PathFinder::distanceTo(int x, int y) {
+    if (x < 0 || y < 0 || x >= m_mapWidth || y >= m_mapHeight)
+        return -1;
+    syncBitboardWave();
+    return waveStep(cellIndex(x, y));
+}
+
+std::vector<std::pair<int, int>> PathFinder::calculatePath(int x, int y) {
+    std::vector<std::pair<int, int>> path;
+    calculatePath(x, y, path);
+    return path;
 }
 
 std::vector<std::pair<int, int>> PathFinder::calculatePath() {
     std::vector<std::pair<int, int>> path;
+    calculatePath(path);
+    return path;
+}
+
+void PathFinder::calculatePath(int x, int y, std::vector<std::pair<int, int>>& path) {
+    path.clear();
+    if (distanceTo(x, y) == -1)
+        return;
+
+    tracePath(cellIndex(x, y), cellIndex(m_startX, m_startY), path, isWeighted() ? costData() : nullptr);
+    std::reverse(path.begin(), path.end());
+}
+
+void PathFinder::calculatePath(std::vector<std::pair<int, int>>& path) {
+    path.clear();
     if (!m_reachedPoint)
-        return path;
-
-    std::pair<int, int> current = { m_endX, m_endY };
-    path.push_back(current);
-    
-    const int dirX[4] = { 0, 1, 0, -1 };
-    const int dirY[4] = { -1, 0, 1, 0 };
-    
-    while (current.first != m_startX || current.second != m_startY) {
-        int currentStep = m_waveMatrix[current.second][current.first];
-        bool found = false;
-    
-        for (int d = 0; d < 4; d++) {
-            int nx = current.first + dirX[d];
-            int ny = current.second + dirY[d];
-    
-            if (ny < 0 || nx < 0 || ny >= m_waveMatrix.size() || nx >= m_waveMatrix[0].size())
-                continue;
-    
-            if (m_waveMatrix[ny][nx] == currentStep - 1) {
-                current = {nx, ny};
-                path.push_back(current);
-                found = true;
-                break;
-            }
-        }
-    
-        if (!found) {
-            //printf("Path reconstruction failed!");
-            break;
-        }
+        return;
+
+    if (!m_flooded && activeSearchMode() == SearchMode::BIDIRECTIONAL) {
+        // START -> meeting cell from the forward wave, meeting cell -> END from the backward one
+        tracePath(m_waveMatrix, m_meetIndex, cellIndex(m_startX, m_startY), path);
+        std::reverse(path.begin(), path.end());
+        size_t meetPosition = path.size() - 1;
+        tracePath(m_backWaveMatrix, m_meetIndex, cellIndex(m_endX, m_endY), path);
+        path.erase(path.begin() + meetPosition);
+        return;
     }
-    std::reverse(path.begin(), path.end());
-    return path;
+
+    if (!m_flooded && activeSearchMode() == SearchMode::JPS) {
+        calculateJumpPath(path);
+        return;
+    }
+
+    if (!m_flooded && activeSearchMode() == SearchMode::BITBOARD) {
+        calculateBitboardPath(path);
+        return;
+    }
+
+    calculatePath(m_endX, m_endY, path);
 }
\ No newline at end of file
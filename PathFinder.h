@@ -2,52 +2,532 @@
 #define __PATH_FINDER_H__
 #include <vector>
 #include <string>
+#include <cstdint>
+#include <climits>
+#include <memory>
+#include <span>
+#include <functional>
+#include <chrono>
+#include <atomic>
+#include <thread>
+#include <future>
+
+class ThreadPool;
+class MappedFile;
+class SharedMap;
 
 class PathFinder {
 public:
-	enum class MapCell {
-		EMPTY = 0, 
-		WALL = 1, 
-		START = 2, 
+	// one byte per cell, the binary map format stores the grid in the same layout
+	enum class MapCell : uint8_t {
+		EMPTY = 0,
+		WALL = 1,
+		START = 2,
 		END = 3
 	};
 	typedef std::vector<std::vector<MapCell>> Map;
 
+	// read-only window into one of the padded grids, no copy is made.
+	// view[y][x] reads cell (x, y). The view stays valid until the map is replaced
+	template<typename T>
+	struct GridView {
+		const T* data;	// cell (0, 0)
+		int width, height;
+		int stride;
+
+		const T* operator[](int y) const { return data + (size_t)y * stride; }
+	};
+
+	struct CellEdit {
+		int x, y;
+		MapCell cell;
+	};
+
+	enum class SearchMode {
+		WAVE,		// cell by cell expansion of the wave front
+		BITBOARD,	// word wide expansion over 8 x 8 cell tiles, pays off on open maps
+		BIDIRECTIONAL,	// waves grow from START and END and meet in the middle
+		PARALLEL,	// every wave level is split across a pool of worker threads
+		ASTAR,		// A* with a Manhattan heuristic over a bucket queue
+		JPS,		// jump point search for 4-connected grids, A* over jump points only
+		WEIGHTED	// Dial's algorithm over the cell costs, the plain wave on unit-cost maps
+	};
+
+	// cells a wave step reaches from a cell
+	enum class Neighbourhood {
+		FOUR,		// up, right, down, left
+		EIGHT,		// plus the diagonals, a diagonal step may squeeze between two walls that touch at a corner
+		EIGHT_NO_CORNER_CUTTING,	// diagonal steps only when both cells beside the step are free
+		HEX			// axial hex grid, every row is shifted half a cell to the right of the one above:
+					// (x, y) touches (x - 1, y), (x + 1, y), (x, y - 1), (x + 1, y - 1), (x, y + 1), (x - 1, y + 1)
+	};
+
+	// how the wave matrix is kept
+	enum class WaveStorage {
+		DENSE,	// one int per cell, allocated once per map. reset() only clears the pages the last search labelled
+		PAGED	// pages of WAVE_PAGE_CELLS cells allocated when the wave labels their first cell, the rest of the
+				// map costs no memory. Every mode runs as WAVE without costs and getWaveMatrixView() stays empty
+	};
+
+	// where buildLandmarks() puts the landmarks
+	enum class LandmarkSelection {
+		FARTHEST,	// every landmark is the cell farthest from the ones before, starting in the region of START.
+				// the floods run one after another
+		BORDER		// free cells spread evenly around the border of the map, flooded in parallel on the worker pool
+	};
+
+	// entering a cell costs 1 to MAX_CELL_COST
+	static constexpr int MAX_CELL_COST = 15;
+	// flow field entry of cells without a move: walls, cells that can't reach the goal and the goal itself
+	static constexpr uint8_t FLOW_NONE = 0xFF;
+	// padded cells per page of the wave matrix
+	static constexpr int WAVE_PAGE_SHIFT = 10;
+	static constexpr int WAVE_PAGE_CELLS = 1 << WAVE_PAGE_SHIFT;
+	static constexpr int MAX_LANDMARKS = 16;
+	// landmark table entry of cells a landmark can't reach, longer distances saturate one below it
+	static constexpr uint16_t LANDMARK_UNREACHABLE = 0xFFFF;
+
+	// search statistics, collected only when compiled with PATH_FINDER_STATS.
+	// without it nothing is measured, the stats stay zero and the step callback is never called.
+	// times are microseconds since the start of the last reset()
+	struct StepStats {
+		int step;
+		int frontier;		// cells the step expanded from, open cells for ASTAR, JPS and WEIGHTED
+		int labelled;		// cells the step labelled, closed cells for ASTAR, JPS and WEIGHTED
+		double start;
+		double duration;
+	};
+
+	struct SearchStats {
+		double resetTime;		// reset() including the buffer allocation
+		double searchTime;		// sum of all processStep() calls
+		long long cellsExpanded;
+		int steps;
+		int maxFrontier;
+		int pathLength;			// cells of the last calculated path, -1 before one is calculated
+		std::vector<StepStats> stepStats;
+	};
+
 	PathFinder();
+	~PathFinder();
 
-	void setMap(Map newMap);
-	void setMap(std::vector<MapCell> newMap, int cols);
+	void setMap(const Map& newMap);
+	void setMap(const std::vector<MapCell>& newMap, int cols);
 	void setMap(std::string);
+	// parses the text map format straight into the grid, on error the current map is kept
+	// and getLastError() tells the line and the problem
+	bool setMap(const char* data, size_t size);
+	// memory-maps a text map file and parses it
+	bool loadMap(const std::string& fileName);
+	const std::string& getLastError() { return m_lastError; }
+	// binary map format: the padded grid is mapped and searched in place, nothing is parsed or copied.
+	// edits touch private copy-on-write pages, the file itself never changes
+	bool loadBinaryMap(const std::string& fileName);
+	bool saveBinaryMap(const std::string& fileName);
+	// searches a read-only map shared with other finders, only the search state is per finder.
+	// START and END markers stay where the shared map has them, setEndpoints() only moves the points.
+	// edits and costs give the finder a private copy of the map first
+	void setMap(std::shared_ptr<const SharedMap> map);
+	// a read-only copy of the map, costs and endpoints that any number of finders and threads can search
+	std::shared_ptr<const SharedMap> shareMap();
+	// the shared map being searched, nullptr for a map of its own or once an edit gave the finder a private copy
+	const std::shared_ptr<const SharedMap>& getSharedMap() { return m_sharedMap; }
+
+	// per-cell costs of entering a cell, row by row, values are clamped to [1, MAX_CELL_COST].
+	// WEIGHTED and ASTAR search by cost, JPS runs as ASTAR while costs are set, the other modes
+	// ignore them. All ones or clearCosts() bring back the unit-cost fast path.
+	// setting costs resets the search, loading another map clears them
+	bool setCosts(const std::vector<uint8_t>& costs, int cols);
+	void setCellCost(int x, int y, int cost);
+	int getCellCost(int x, int y);
+	void clearCosts();
+	bool hasCosts() { return costData() != nullptr; }
+
+	// edits the map and repairs the wave matrix and the final path, only cells whose wave step
+	// changes are touched. The repair works on the full flood of processAll(), which is run once
+	// if the current search doesn't cover the whole map. Moving START floods again.
+	void setCell(int x, int y, MapCell cell);
+	void setCells(const std::vector<CellEdit>& edits);
 
-	Map getMap() { return m_map; }
+	Map getMap();
 	std::string getMapAsString();
 
-	std::vector<std::vector<int>> getWaveMatrix() { return m_waveMatrix; }
+	std::vector<std::vector<int>> getWaveMatrix();
+
+	// views and spans of the internal buffers, for callers that read every frame
+	GridView<MapCell> getMapView() { return { m_map ? m_map + m_stride + 1 : nullptr, m_mapWidth, m_mapHeight, m_stride }; }
+	// cells the wave hasn't labelled are -1, empty before the first search
+	GridView<int> getWaveMatrixView();
+	std::span<const std::pair<int, int>> getFinalPathView() { return m_finalPath; }
+
+	int getMapWidth() { return m_mapWidth; }
+	int getMapHeight() { return m_mapHeight; }
+
+	// moves START and END without reloading the map and resets the search,
+	// returns false if a point lies outside of the map
+	bool setEndpoints(int startX, int startY, int endX, int endY);
 
 	void reset();
 
+	// switching the mode resets the search
+	void setSearchMode(SearchMode mode);
+	SearchMode getSearchMode() { return m_searchMode; }
+	// every mode but WAVE is written for four neighbours, with another neighbourhood all of them
+	// run the wave and costs are ignored. Switching the neighbourhood resets the search
+	void setNeighbourhood(Neighbourhood neighbourhood);
+	Neighbourhood getNeighbourhood() { return m_neighbourhood; }
+	// switching the storage resets the search. PAGED suits large maps with short queries, a search
+	// then costs memory and time in proportion to the cells it labels
+	void setWaveStorage(WaveStorage storage);
+	WaveStorage getWaveStorage() { return m_waveStorage; }
+	// bytes held by the wave matrix or its pages
+	size_t getWaveMemoryUsage();
+	// worker threads used by SearchMode::PARALLEL, threadCount < 1 uses all hardware threads
+	void setThreadCount(int threadCount);
+
 	void process();
+	// writes the path into a caller-owned buffer instead of getFinalPath(), which is left empty.
+	// the buffer is cleared first and its capacity reused, so repeated queries don't allocate
+	void process(std::vector<std::pair<int, int>>& path);
 	void processStep();
+	// budgeted search: works until the budget is spent and returns, the next call resumes where this
+	// one stopped, in the middle of a wave level if need be. Returns true once the search is finished,
+	// the path is then calculated as by process(). WAVE, ASTAR, JPS and WEIGHTED stop after any cell,
+	// the other modes expand whole levels, so they stop at the first level end past the budget
+	bool processFor(long long maxCells);
+	bool processFor(std::chrono::microseconds maxTime);
+	// runs the search on its own thread. The future turns true once the search is finished and false
+	// if cancel() stopped it; a cancelled search can be resumed. Until the future is ready only
+	// cancel() may be called
+	std::future<bool> processAsync();
+	// stops processAsync() and waits for its thread, the finder can be used again afterwards
+	void cancel();
+	// floods everything reachable from START without stopping at END and keeps the wave matrix,
+	// after that distanceTo() and calculatePath(x, y) answer any target without searching again
+	void processAll();
+	bool isFlooded() { return m_flooded; }
 
 	std::vector<std::pair<int, int>> calculatePath();
+	// path from START to (x, y), works for every cell the wave has labelled
+	std::vector<std::pair<int, int>> calculatePath(int x, int y);
+	// the same paths written into a caller-owned buffer
+	void calculatePath(std::vector<std::pair<int, int>>& path);
+	void calculatePath(int x, int y, std::vector<std::pair<int, int>>& path);
+	// wave steps from START to (x, y) or -1 if the wave hasn't labelled it, the path cost for weighted searches
+	int distanceTo(int x, int y);
+
+	const SearchStats& getStats() { return m_stats; }
+	// called after every processStep()
+	void setStepCallback(std::function<void(const StepStats&)> callback) { m_stepCallback = std::move(callback); }
+	// the last search as Chrome trace events, for chrome://tracing or Perfetto
+	std::string getTraceJson();
+	bool saveTrace(const std::string& fileName);
+
+	// flow field towards END: one flood backwards from END stores for every cell the direction of its
+	// next step on a shortest path, so any number of agents heading for END read their moves in O(1).
+	// the field uses the current neighbourhood and follows the costs with FOUR. It is independent of
+	// the search, setEndpoints() doesn't move its goal, and map, cost or neighbourhood changes drop it
+	bool buildFlowField();
+	// moves END and updates the field, only cells that get closer to the new goal are visited
+	bool moveFlowGoal(int x, int y);
+	bool hasFlowField() { return m_flowGoal != -1; }
+	// next cell from (x, y) towards the goal, false on the goal, on walls, if the goal can't be
+	// reached or without a field
+	bool getFlowMove(int x, int y, int& nextX, int& nextY);
+	// steps (or cost) from (x, y) to the goal, -1 if it can't be reached
+	int getFlowDistance(int x, int y);
+	// per-cell direction index into the neighbourhood or FLOW_NONE. FOUR and EIGHT count up, right, down,
+	// left, up-right, down-right, down-left, up-left, HEX up, up-right, right, down, down-left, left
+	GridView<uint8_t> getFlowFieldView();
+
+	// connected components of the free cells under the current neighbourhood, labelled by a union-find
+	// that runs over bands of rows on the worker pool. Once built, a search whose START and END lie in
+	// different components ends in reset() without expanding a cell. Cell edits keep the labels up to
+	// date, loading another map or switching the neighbourhood drops them
+	void buildComponents();
+	bool hasComponents() { return !m_components.empty(); }
+	// component id of (x, y), -1 for walls, cells outside of the map or without components
+	int getComponent(int x, int y);
+	bool isConnected(int x1, int y1, int x2, int y2);
+	int getComponentCount() { return (int)(m_componentSizes.size() - m_freeComponents.size()); }
+
+	// landmarks for goal-directed search: a table holds the wave steps from every landmark to every cell,
+	// and |steps(L, a) - steps(L, b)| never exceeds the steps between a and b. ASTAR and JPS use the
+	// largest of these bounds and the Manhattan distance as their heuristic, which cuts the cells they
+	// expand on maps with long detours; costs only make paths longer, so the bounds hold with them too.
+	// the table takes 2 bytes per cell and landmark. Loading a map, wall edits and switching the
+	// neighbourhood drop it, returns false if no landmark could be placed
+	bool buildLandmarks(int count, LandmarkSelection selection = LandmarkSelection::FARTHEST);
+	// landmarks at chosen free cells, flooded in parallel like BORDER
+	bool setLandmarks(const std::vector<std::pair<int, int>>& cells);
+	void clearLandmarks();
+	bool hasLandmarks() { return !m_landmarks.empty(); }
+	std::vector<std::pair<int, int>> getLandmarks();
+	size_t getLandmarkMemoryUsage() { return m_landmarkTable.capacity() * sizeof(uint16_t); }
+	// steps between two cells from the tables alone: lower is the best landmark bound, upper the shortest
+	// way through a landmark or -1 if every such way is too long for the table. False if no landmark reaches
+	// both cells, which includes cells in different components
+	bool estimateDistance(int x1, int y1, int x2, int y2, int& lower, int& upper);
 
 	bool isPointReached() { return m_reachedPoint; }
 	std::vector<std::pair<int, int>> getFinalPath() { return m_finalPath; }
 protected:
-	Map m_map;
-	std::vector<std::vector<int>> m_waveMatrix;
-	std::vector<std::pair<int, int>> m_wave;
+	// map and wave matrix are flat row-major buffers surrounded by a one cell WALL border,
+	// so neighbours of any inner cell can be visited without bounds checks.
+	// cell (x, y) is stored at index (y + 1) * m_stride + (x + 1).
+	// m_map points into m_mapStorage, or into m_mappedFile for a binary map
+	MapCell* m_map;
+	size_t m_mapSize;
+	std::vector<MapCell> m_mapStorage;
+	std::unique_ptr<MappedFile> m_mappedFile;
+	std::vector<int> m_waveMatrix;
+	// pages of the wave matrix the current search labelled cells on: the dirty pages of a DENSE matrix, which
+	// m_pageTouched flags as well, or the allocated pages of a PAGED one, which m_wavePages points to
+	WaveStorage m_waveStorage;
+	std::vector<int> m_touchedPages;
+	std::vector<uint8_t> m_pageTouched;
+	// false while an engine labels cells without listing their pages, reset() then clears the whole matrix
+	bool m_pagesTracked;
+	std::vector<int*> m_wavePages;
+	std::vector<std::unique_ptr<int[]>> m_wavePagePool;
+	std::vector<int*> m_freeWavePages;
+	// waves hold flat cell indices
+	std::vector<int> m_wave;
+	std::vector<int> m_oldWave;
 	std::vector<std::pair<int, int>> m_finalPath;
-	std::vector<std::pair<int, int>> m_oldWave;
 	int m_waveStep;
+	// a wave level stopped by a budget resumes at this cell of m_oldWave, m_wave holds the next level so far
+	size_t m_waveCursor;
+	// cost of entering each padded cell, empty for a unit-cost map
+	std::vector<uint8_t> m_costs;
+	// set while m_map points into a shared map, whose costs are used instead of m_costs
+	std::shared_ptr<const SharedMap> m_sharedMap;
 
 	int m_mapWidth;
 	int m_mapHeight;
+	int m_stride;
 
 	bool m_reachedPoint;
 
 	int m_startX, m_startY, m_endX, m_endY;
+
+	std::string m_lastError;
+
+	SearchMode m_searchMode;
+	Neighbourhood m_neighbourhood;
+	// m_floodAll is set while processAll() runs, m_flooded once the whole reachable area is labelled
+	bool m_floodAll;
+	bool m_flooded;
+
+	// bitboard engine state: the padded map in tiles of 8 x 8 cells, one 64-bit word per tile, row by row.
+	// a ring of guard tiles surrounds the map. The free tiles are built once per map
+	std::vector<uint64_t> m_freeBits;
+	std::vector<uint64_t> m_visitedBits;
+	std::vector<uint64_t> m_frontierBits;
+	std::vector<uint64_t> m_nextBits;
+	// bit 0 and bit 1 of the step of every visited cell
+	std::vector<uint64_t> m_stepLowBits;
+	std::vector<uint64_t> m_stepHighBits;
+	// tiles with frontier bits and tiles with visited bits, so a step and reset() touch only those
+	std::vector<int> m_frontierTiles;
+	std::vector<int> m_nextTiles;
+	std::vector<int> m_visitedTiles;
+	// the step a tile was last expanded in, so a tile next to several frontier tiles is expanded once
+	std::vector<uint32_t> m_tileStamps;
+	uint32_t m_tileStamp;
+	int m_bitTilesX;
+	// cells of the current frontier, the engine leaves only START in m_oldWave until the frontier dies out
+	long long m_bitFrontierCells;
+	// m_waveMatrix is filled in up to m_syncStep, m_syncWave holds the cells of that level
+	std::vector<int> m_syncWave;
+	int m_syncStep;
+
+	// bidirectional search state: the wave grown from END and the cell where both waves met
+	std::vector<int> m_backWaveMatrix;
+	std::vector<int> m_backWave;
+	std::vector<int> m_oldBackWave;
+	int m_backWaveStep;
+	int m_meetIndex;
+
+	// A* and JPS state: open cells sit in a ring of buckets indexed by f = g + h, g is kept in m_waveMatrix
+	// every bucket is a LIFO list through m_openEntries: cell index and the next entry, -1 ends it
+	std::vector<int> m_bucketHeads;
+	std::vector<std::pair<int, int>> m_openEntries;
+	int m_bucketMask;
+	int m_currentF;
+	long long m_openCount;
+	std::vector<uint8_t> m_closed;
+	// JPS links every jump point to the one it was reached from and the direction it came in
+	std::vector<int> m_jumpParent;
+	std::vector<int8_t> m_jumpDirection;
+	// per cell the cell a horizontal jump to the right or left stops at: the first jump point or the wall
+	// ending the run. Built on the first JPS search of a map, wall changes drop it
+	std::vector<int> m_jumpRight;
+	std::vector<int> m_jumpLeft;
+
+	// parallel search state: the pool is created on first use, every worker collects its part of the next wave
+	std::unique_ptr<ThreadPool> m_threadPool;
+	std::vector<std::vector<int>> m_localWaves;
+	int m_threadCount;
+	long long m_unvisitedCells;
+
+	SearchStats m_stats;
+	std::function<void(const StepStats&)> m_stepCallback;
+	std::chrono::steady_clock::time_point m_statsOrigin;
+
+	// flow field state: a direction and a distance per padded cell. Distances are stored relative to
+	// m_flowOffset, moving the goal raises the offset instead of touching every cell.
+	// m_flowGoal is the padded goal cell, -1 without a field
+	std::vector<uint8_t> m_flowDirections;
+	std::vector<int> m_flowDistances;
+	int m_flowOffset;
+	int m_flowGoal;
+	int m_flowSteps[8];
+	std::vector<std::vector<int>> m_flowBuckets;
+
+	// component id per padded cell, -1 for walls, empty without components. Ids of components that
+	// vanished or merged go to m_freeComponents and are handed out again
+	std::vector<int> m_components;
+	std::vector<int> m_componentSizes;
+	std::vector<int> m_freeComponents;
+	std::vector<int> m_componentQueue;
+
+	// landmark table, cell-major: the distances of padded cell i start at i * m_landmarks.size(),
+	// so a heuristic lookup reads one short run of memory. m_landmarks holds their padded cells
+	std::vector<uint16_t> m_landmarkTable;
+	std::vector<int> m_landmarks;
+
+	std::thread m_asyncThread;
+	std::atomic<bool> m_cancelRequested;
+
+	int cellIndex(int x, int y) const { return (y + 1) * m_stride + (x + 1); }
+	std::pair<int, int> cellPoint(int index) const { return { index % m_stride - 1, index / m_stride - 1 }; }
+	// cell that stops the wave, none while flooding the whole map
+	int targetIndex() const { return m_floodAll ? -1 : cellIndex(m_endX, m_endY); }
+	// padded cell costs or nullptr for a unit-cost map
+	const uint8_t* costData() const;
+	// the search runs by cell costs instead of unit steps
+	bool isWeighted() const {
+		return costData() != nullptr && m_waveStorage == WaveStorage::DENSE && m_neighbourhood == Neighbourhood::FOUR && (m_searchMode == SearchMode::WEIGHTED || m_searchMode == SearchMode::ASTAR || m_searchMode == SearchMode::JPS);
+	}
 private:
+	void allocateMap(int width, int height);
+	void useMapStorage();
+	// copies a shared map into m_mapStorage before the map or the costs are changed
+	void detachSharedMap();
+	void storeCell(int x, int y, MapCell cell);
+
+	// wave steps of either storage for the engines that run on both
+	struct DenseWave {
+		int* cells;
+		PathFinder* finder;
+
+		int get(int index) const { return cells[index]; }
+		void set(int index, int step) {
+			cells[index] = step;
+			finder->markTouched(index);
+		}
+	};
+	struct PagedWave {
+		PathFinder* finder;
+
+		int get(int index) const {
+			const int* page = finder->m_wavePages[index >> WAVE_PAGE_SHIFT];
+			return page ? page[index & (WAVE_PAGE_CELLS - 1)] : -1;
+		}
+		void set(int index, int step) {
+			int*& page = finder->m_wavePages[index >> WAVE_PAGE_SHIFT];
+			if (!page)
+				page = finder->allocateWavePage(index >> WAVE_PAGE_SHIFT);
+			page[index & (WAVE_PAGE_CELLS - 1)] = step;
+		}
+	};
+	void markTouched(int index) {
+		uint8_t& touched = m_pageTouched[index >> WAVE_PAGE_SHIFT];
+		if (!touched) {
+			touched = 1;
+			m_touchedPages.push_back(index >> WAVE_PAGE_SHIFT);
+		}
+	}
+	int* allocateWavePage(int page);
+	// clears the wave matrices and the per-cell A* and JPS state, only on the touched pages if all were listed
+	void clearSearchCells();
+	// -1 for unlabelled cells and before the first search
+	int waveStep(int index) const;
+
+	// the engine processStep() runs for the current mode, neighbourhood, costs and flood
+	SearchMode activeSearchMode() const;
+	// expands at most maxCells cells of the engines that can stop anywhere, whole steps of the others
+	long long processCells(long long maxCells);
+	bool finishBudgetedSearch();
+
+	// the step functions below expand at most maxCells cells and return how many they expanded
+	long long processWaveStep(long long maxCells = LLONG_MAX);
+	// one wave level over the neighbourhood policy, the directions are unrolled at compile time
+	template<class Wave> long long expandNeighbourhood(Wave wave, long long maxCells);
+	template<class Neighbours, class Wave> long long expandWave(Wave wave, long long maxCells);
+	template<class Wave> void traceNeighbourhood(Wave wave, int from, int to, std::vector<std::pair<int, int>>& path, const uint8_t* costs);
+	template<class Neighbours, class Wave> void traceWave(Wave wave, int from, int to,
+		std::vector<std::pair<int, int>>& path, const uint8_t* costs);
+	void resetBitboard();
+	void buildFreeBits();
+	void processBitboardStep();
+	void calculateBitboardPath(std::vector<std::pair<int, int>>& path);
+	void syncBitboardWave();
+	// tile and bit of a padded cell in the bitboard tiles
+	size_t bitTile(int index) const { return (size_t)((index / m_stride >> 3) + 1) * m_bitTilesX + (index % m_stride >> 3) + 1; }
+	uint64_t bitMask(int index) const { return uint64_t(1) << ((index / m_stride & 7) * 8 + (index % m_stride & 7)); }
+	void resetBidirectional();
+	void processBidirectionalStep();
+	void resetHeuristic();
+	long long processAStarStep(long long maxCells = LLONG_MAX);
+	long long processJumpPointStep(long long maxCells = LLONG_MAX);
+	int heuristic(int index) const;
+	void pushOpen(int index, int g);
+	int popOpen();
+	void buildJumpTable();
+	int jumpHorizontal(int index, int dx) const;
+	int jumpVertical(int index, int dy) const;
+	void calculateJumpPath(std::vector<std::pair<int, int>>& path);
+	void resetParallel();
+	void processParallelStep();
+	int expandBidirectionalWave(std::vector<int>& waveMatrix, const std::vector<int>& otherWaveMatrix,
+		std::vector<int>& oldWave, std::vector<int>& wave, int& waveStep);
+
+	// lowers the flow distances from the goal on, every cell that gets closer points to the cell that lowered it.
+	// previousGoal, if not -1, has no direction yet and gets one afterwards
+	void propagateFlowField(int previousGoal);
+	template<class Neighbours> void propagateFlowField(const uint8_t* costs, int previousGoal);
+
+	void repairWaveMatrix(const std::vector<int>& walledCells, const std::vector<int>& freedCells);
+
+	template<class Neighbours> void buildComponents();
+	// keeps the components right after one cell turned into a wall or stopped being one
+	void updateComponents(int index, bool walled);
+	template<class Neighbours> void addComponentCell(int index);
+	template<class Neighbours> void removeComponentCell(int index);
+	template<class Neighbours> void relabelComponent(int seed, int from, int to);
+	int newComponent();
+	void releaseComponent(int component);
+
+	// wave steps from landmark into plane, which has one entry per padded cell
+	void floodLandmark(int landmark, uint16_t* plane, std::vector<int>& wave, std::vector<int>& nextWave) const;
+	template<class Neighbours> void floodLandmark(int landmark, uint16_t* plane, std::vector<int>& wave, std::vector<int>& nextWave) const;
+	// fills the table for m_landmarks, a round of floods per pool run, each followed by a parallel transpose
+	void floodLandmarks();
+	// largest landmark bound on the steps between two padded cells, 0 without a landmark reaching both
+	int landmarkBound(int from, int to) const;
+
+	void resetStats();
+	void recordReset();
+	void recordStep(std::chrono::steady_clock::time_point start, int frontier, int labelled);
+	void recordPath(size_t length);
+	double statsTime(std::chrono::steady_clock::time_point time) const;
+
+	void tracePath(const std::vector<int>& waveMatrix, int from, int to, std::vector<std::pair<int, int>>& path, const uint8_t* costs = nullptr);
+	// the same over the forward wave in its storage
+	void tracePath(int from, int to, std::vector<std::pair<int, int>>& path, const uint8_t* costs = nullptr);
+
 	void log(std::string);
 };
 
@@ -0,0 +1,81 @@
+#include "PathFinder.h"
+
+/*
+bidirectional wave search
+one wave grows from START over m_waveMatrix, the other from END over m_backWaveMatrix.
+every step expands a whole level of the smaller wave and stops at the first cell the other
+wave has already labelled. Before that step no cell was labelled by both waves, so any path
+is at least (forward level + backward level) long and the first meeting cell lies on a
+shortest path - the result has the same length as the unidirectional wave.
+both waves note the pages they label in one list, so reset() refills only those pages of both matrices.
+*/
+
+void PathFinder::resetBidirectional() {
+    int endIndex = cellIndex(m_endX, m_endY);
+
+    m_backWaveStep = 0;
+    // clearSearchCells() has refilled the pages of the last search, the matrix is only filled when it's new
+    if (m_backWaveMatrix.size() != m_mapSize)
+        m_backWaveMatrix.assign(m_mapSize, -1);
+    m_backWaveMatrix[endIndex] = 0;
+    markTouched(endIndex);
+    m_backWave.clear();
+    m_oldBackWave.clear();
+    // the forward wave never enters a WALL, so an END placed on one can't be met either
+    if (m_map[endIndex] != MapCell::WALL || m_reachedPoint)
+        m_oldBackWave.push_back(endIndex);
+    m_meetIndex = m_reachedPoint ? endIndex : -1;
+}
+
+void PathFinder::processBidirectionalStep() {
+    if (m_oldBackWave.empty()) {
+        // the END side is enclosed, nothing left to meet
+        m_oldWave.clear();
+        return;
+    }
+
+    int meetIndex;
+    if (m_oldWave.size() <= m_oldBackWave.size())
+        meetIndex = expandBidirectionalWave(m_waveMatrix, m_backWaveMatrix, m_oldWave, m_wave, m_waveStep);
+    else
+        meetIndex = expandBidirectionalWave(m_backWaveMatrix, m_waveMatrix, m_oldBackWave, m_backWave, m_backWaveStep);
+
+    if (meetIndex != -1) {
+        m_meetIndex = meetIndex;
+        m_reachedPoint = true;
+    }
+}
+
+// expands one level of a wave, returns the first cell already labelled by the other wave or -1
+int PathFinder::expandBidirectionalWave(std::vector<int>& waveMatrix, const std::vector<int>& otherWaveMatrix,
+    std::vector<int>& oldWave, std::vector<int>& wave, int& waveStep) {
+    const int offsets[4] = { -m_stride, 1, m_stride, -1 };
+
+    const MapCell* map = m_map;
+    int meetIndex = -1;
+
+    int nextStep = waveStep + 1;
+    wave.clear();
+
+    for (int i = 0; i < (int)oldWave.size() && meetIndex == -1; i++) {
+        int current = oldWave[i];
+        for (int d = 0; d < 4; d++) {
+            int next = current + offsets[d];
+
+            if (map[next] == MapCell::WALL || waveMatrix[next] != -1)
+                continue;
+
+            waveMatrix[next] = nextStep;
+            markTouched(next);
+            wave.push_back(next);
+
+            if (otherWaveMatrix[next] != -1) {
+                meetIndex = next;
+                break;
+            }
+        }
+    }
+    waveStep = nextStep;
+    oldWave.swap(wave);
+    return meetIndex;
+}
\ No newline at end of file
@@ -0,0 +1,155 @@
+#include "PathFinder.h"
+#include "MappedFile.h"
+#include <cstdio>
+#include <cstring>
+
+/*
+binary map format
+a 32 byte header followed by the padded grid exactly as PathFinder keeps it in memory:
+one byte per cell, (width + 2) * (height + 2) cells row by row, the outer ring is WALL.
+START and END are marked in the grid and their points are repeated in the header.
+all header fields are little-endian 32-bit integers.
+
+loadBinaryMap() maps the file and points the search at the grid inside it, nothing is parsed or
+copied. Start-up costs an mmap(), a walk around the border and one read over the grid that rejects
+bytes which are no MapCell, eight cells at a time.
+*/
+
+static const char BINARY_MAP_MAGIC[4] = { 'W', 'A', 'V', 'M' };
+static const uint32_t BINARY_MAP_VERSION = 1;
+
+struct BinaryMapHeader {
+    char magic[4];
+    uint32_t version;
+    int32_t width, height;
+    int32_t startX, startY;
+    int32_t endX, endY;
+};
+static_assert(sizeof(BinaryMapHeader) == 32, "the header layout is part of the file format");
+
+bool PathFinder::loadBinaryMap(const std::string& fileName) {
+    auto fail = [&](const std::string& message) {
+        m_lastError = fileName + ": " + message;
+        log("loadBinaryMap: " + m_lastError);
+        return false;
+    };
+
+    std::unique_ptr<MappedFile> file = std::make_unique<MappedFile>();
+    if (!file->open(fileName, true))
+        return fail("can't open");
+
+    BinaryMapHeader header;
+    if (file->getSize() < sizeof(header))
+        return fail("file is too short");
+    std::memcpy(&header, file->getData(), sizeof(header));
+
+    if (std::memcmp(header.magic, BINARY_MAP_MAGIC, sizeof(BINARY_MAP_MAGIC)) != 0)
+        return fail("not a binary map");
+    if (header.version != BINARY_MAP_VERSION)
+        return fail("unsupported version " + std::to_string(header.version));
+    if (header.width < 1 || header.height < 1 || header.width > (1 << 30) || header.height > (1 << 30))
+        return fail("bad map size");
+
+    const size_t stride = (size_t)header.width + 2;
+    const size_t rows = (size_t)header.height + 2;
+    if (stride * rows > (size_t)INT32_MAX || file->getSize() != sizeof(header) + stride * rows)
+        return fail("file size doesn't match the map size");
+
+    auto isInside = [&](int x, int y) { return x >= 0 && y >= 0 && x < header.width && y < header.height; };
+    if (!isInside(header.startX, header.startY) || !isInside(header.endX, header.endY))
+        return fail("START or END lies outside of the map");
+
+    // the search relies on the border, a broken one would let the wave leave the buffer
+    MapCell* grid = (MapCell*)(file->getWritableData() + sizeof(header));
+    for (size_t x = 0; x < stride; x++) {
+        if (grid[x] != MapCell::WALL || grid[(rows - 1) * stride + x] != MapCell::WALL)
+            return fail("border is not a wall");
+    }
+    for (size_t y = 1; y < rows - 1; y++) {
+        if (grid[y * stride] != MapCell::WALL || grid[y * stride + stride - 1] != MapCell::WALL)
+            return fail("border is not a wall");
+    }
+
+    // every cell is 0 to 3, so only the low two bits of a byte may be set
+    static_assert((int)MapCell::END == 3, "the cell check masks the two low bits");
+    const uint8_t* bytes = (const uint8_t*)grid;
+    const size_t cells = stride * rows;
+    size_t index = 0;
+    for (; index + sizeof(uint64_t) <= cells; index += sizeof(uint64_t)) {
+        uint64_t word;
+        std::memcpy(&word, bytes + index, sizeof(word));
+        if (word & 0xFCFCFCFCFCFCFCFCull)
+            break;
+    }
+    for (; index < cells; index++) {
+        if (bytes[index] > (uint8_t)MapCell::END)
+            return fail("bad cell value " + std::to_string(bytes[index]) + " at " + std::to_string(index % stride - 1)
+                + "," + std::to_string(index / stride - 1));
+    }
+
+    std::vector<MapCell>().swap(m_mapStorage);
+    m_sharedMap.reset();
+    m_costs.clear();
+    m_flowGoal = -1;
+    m_components.clear();
+    m_landmarks.clear();
+    m_landmarkTable.clear();
+    m_jumpRight.clear();
+    m_jumpLeft.clear();
+    m_freeBits.clear();
+    m_map = grid;
+    m_mapSize = stride * rows;
+    m_mappedFile = std::move(file);
+
+    m_mapWidth = header.width;
+    m_mapHeight = header.height;
+    m_stride = (int)stride;
+    m_startX = header.startX;
+    m_startY = header.startY;
+    m_endX = header.endX;
+    m_endY = header.endY;
+    m_lastError.clear();
+    reset();
+    return true;
+}
+
+bool PathFinder::saveBinaryMap(const std::string& fileName) {
+    if (m_mapSize == 0) {
+        m_lastError = "no map to save";
+        log("saveBinaryMap: " + m_lastError);
+        return false;
+    }
+
+    BinaryMapHeader header;
+    std::memcpy(header.magic, BINARY_MAP_MAGIC, sizeof(BINARY_MAP_MAGIC));
+    header.version = BINARY_MAP_VERSION;
+    header.width = m_mapWidth;
+    header.height = m_mapHeight;
+    header.startX = m_startX;
+    header.startY = m_startY;
+    header.endX = m_endX;
+    header.endY = m_endY;
+
+    // written next to the target and renamed, the target may be the file this map is mapped from
+    std::string tempName = fileName + ".tmp";
+    FILE* file = std::fopen(tempName.c_str(), "wb");
+    bool written = file != nullptr;
+    if (file) {
+        written = std::fwrite(&header, sizeof(header), 1, file) == 1;
+        written = written && std::fwrite(m_map, 1, m_mapSize, file) == m_mapSize;
+        written = std::fclose(file) == 0 && written;
+    }
+    if (written) {
+        std::remove(fileName.c_str());
+        written = std::rename(tempName.c_str(), fileName.c_str()) == 0;
+    }
+
+    if (!written) {
+        std::remove(tempName.c_str());
+        m_lastError = "can't write " + fileName;
+        log("saveBinaryMap: " + m_lastError);
+        return false;
+    }
+    m_lastError.clear();
+    return true;
+}
\ No newline at end of file
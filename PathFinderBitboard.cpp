@@ -0,0 +1,213 @@
+#include "PathFinder.h"
+#include <algorithm>
+#include <bit>
+
+/*
+bit-parallel wave expansion
+the padded map is cut into tiles of 8 x 8 cells, bit (y % 8) * 8 + (x % 8) of a tile's word is cell (x, y).
+one wave step for a tile is
+    next = (frontier spread one cell up, right, down and left) & free & ~visited
+where the spread shifts the tile's word and carries the edge rows and columns of the four neighbouring
+tiles in, the same up/right/down/left expansion processWaveStep() does cell by cell. Square tiles keep a
+wave front dense in its words whichever way it runs, a diamond around START fills about eight cells of
+every tile it crosses where a row of words would hold one or two.
+only the tiles on the frontier and the neighbours their edge cells reach are expanded, so a step costs
+the length of the front and not the area between its sides.
+
+the engine never handles a single cell during the search. The step of every visited cell is kept
+modulo 4 in two bit planes, written a tile at a time. On a 4-connected grid neighbours lie exactly one
+step apart, so of the visited neighbours of a cell only the ones closer to START have the step below
+it modulo 4, and calculatePath() walks back from END on the bits alone. distanceTo() and the matrix
+views fill m_waveMatrix in with the plain wave up to the current level when they are called.
+the free tiles are built once per map and follow setCells(), reset() clears only the tiles the last
+search visited.
+*/
+
+static const uint64_t TILE_COLUMN_0 = 0x0101010101010101ull;
+static const uint64_t TILE_COLUMN_7 = 0x8080808080808080ull;
+static const uint64_t TILE_ROW_0 = 0x00000000000000ffull;
+static const uint64_t TILE_ROW_7 = 0xff00000000000000ull;
+
+// the cells one step away from the frontier of a tile and the edges of its neighbours
+static uint64_t spreadTile(const uint64_t* frontier, int tile, int tilesX) {
+    uint64_t f = frontier[tile];
+    return ((f << 1) & ~TILE_COLUMN_0) | ((frontier[tile - 1] >> 7) & TILE_COLUMN_0)
+         | ((f >> 1) & ~TILE_COLUMN_7) | ((frontier[tile + 1] << 7) & TILE_COLUMN_7)
+         | (f << 8) | (frontier[tile - tilesX] >> 56)
+         | (f >> 8) | (frontier[tile + tilesX] << 56);
+}
+
+void PathFinder::resetBitboard() {
+    const int tilesX = ((m_stride + 7) >> 3) + 2;
+    const size_t tiles = (size_t)tilesX * (((m_mapHeight + 2 + 7) >> 3) + 2);
+
+    // a map of another shape gets new buffers, otherwise the last search clears what it left behind
+    if (tilesX != m_bitTilesX || m_visitedBits.size() != tiles) {
+        m_bitTilesX = tilesX;
+        m_visitedBits.assign(tiles, 0);
+        m_frontierBits.assign(tiles, 0);
+        m_nextBits.assign(tiles, 0);
+        m_stepLowBits.assign(tiles, 0);
+        m_stepHighBits.assign(tiles, 0);
+        m_tileStamps.assign(tiles, 0);
+        m_tileStamp = 0;
+        m_freeBits.clear();
+    }
+    else {
+        for (int tile : m_visitedTiles)
+            m_visitedBits[tile] = 0;
+        for (int tile : m_frontierTiles)
+            m_frontierBits[tile] = 0;
+    }
+    m_visitedTiles.clear();
+    m_frontierTiles.clear();
+    if (m_freeBits.size() != tiles)
+        buildFreeBits();
+
+    // the step planes are never cleared, a cell's bits are written when it is visited
+    const int startIndex = cellIndex(m_startX, m_startY);
+    const size_t startTile = bitTile(startIndex);
+    const uint64_t startBit = bitMask(startIndex);
+    m_visitedBits[startTile] = startBit;
+    m_frontierBits[startTile] = startBit;
+    m_stepLowBits[startTile] &= ~startBit;
+    m_stepHighBits[startTile] &= ~startBit;
+    m_visitedTiles.push_back((int)startTile);
+    m_frontierTiles.push_back((int)startTile);
+
+    m_bitFrontierCells = 1;
+    m_syncWave.assign(1, startIndex);
+    m_syncStep = 0;
+}
+
+void PathFinder::buildFreeBits() {
+    m_freeBits.assign(m_visitedBits.size(), 0);
+    for (int y = 1; y <= m_mapHeight; y++) {
+        for (int x = 1; x <= m_mapWidth; x++) {
+            int index = y * m_stride + x;
+            if (m_map[index] != MapCell::WALL)
+                m_freeBits[bitTile(index)] |= bitMask(index);
+        }
+    }
+}
+
+void PathFinder::processBitboardStep() {
+    const int tilesX = m_bitTilesX;
+    const int endIndex = targetIndex();
+    const uint64_t* frontier = m_frontierBits.data();
+    const uint64_t* free = m_freeBits.data();
+    uint64_t* visited = m_visitedBits.data();
+    uint64_t* next = m_nextBits.data();
+    uint64_t* low = m_stepLowBits.data();
+    uint64_t* high = m_stepHighBits.data();
+
+    int nextStep = m_waveStep + 1;
+    const uint64_t lowStep = nextStep & 1 ? ~uint64_t(0) : 0;
+    const uint64_t highStep = nextStep & 2 ? ~uint64_t(0) : 0;
+    long long reachedCells = 0;
+
+    // the stamps wrap after 2^32 steps, they are cleared then so no tile keeps a stamp of this step
+    if (++m_tileStamp == 0) {
+        std::fill(m_tileStamps.begin(), m_tileStamps.end(), 0);
+        m_tileStamp = 1;
+    }
+    const uint32_t stamp = m_tileStamp;
+    uint32_t* stamps = m_tileStamps.data();
+
+    auto expand = [&](int tile) {
+        if (stamps[tile] == stamp)
+            return;
+        stamps[tile] = stamp;
+
+        uint64_t bits = spreadTile(frontier, tile, tilesX) & free[tile] & ~visited[tile];
+        if (!bits)
+            return;
+
+        if (!visited[tile])
+            m_visitedTiles.push_back(tile);
+        visited[tile] |= bits;
+        next[tile] = bits;
+        low[tile] = (low[tile] & ~bits) | (bits & lowStep);
+        high[tile] = (high[tile] & ~bits) | (bits & highStep);
+        reachedCells += std::popcount(bits);
+        m_nextTiles.push_back(tile);
+    };
+
+    // a neighbouring tile can be reached only through the frontier cells on the edge it shares
+    m_nextTiles.clear();
+    for (int tile : m_frontierTiles) {
+        uint64_t f = frontier[tile];
+        expand(tile);
+        if (f & TILE_ROW_0)
+            expand(tile - tilesX);
+        if (f & TILE_COLUMN_7)
+            expand(tile + 1);
+        if (f & TILE_ROW_7)
+            expand(tile + tilesX);
+        if (f & TILE_COLUMN_0)
+            expand(tile - 1);
+    }
+
+    // the consumed frontier is cleared, so its buffer can be reused as the next one
+    for (int tile : m_frontierTiles)
+        m_frontierBits[tile] = 0;
+    m_frontierBits.swap(m_nextBits);
+    m_frontierTiles.swap(m_nextTiles);
+
+    m_waveStep = nextStep;
+    m_bitFrontierCells = reachedCells;
+    if (endIndex != -1 && (m_visitedBits[bitTile(endIndex)] & bitMask(endIndex)))
+        m_reachedPoint = true;
+    // the loops that run the search wait for an empty wave
+    if (reachedCells == 0)
+        m_oldWave.clear();
+}
+
+// walks back from END, the neighbour one step closer to START is the visited one whose step is one lower modulo 4.
+// the directions are tried in the order tracePath() tries them, so the path is the one WAVE finds
+void PathFinder::calculateBitboardPath(std::vector<std::pair<int, int>>& path) {
+    const int offsets[4] = { -m_stride, 1, m_stride, -1 };
+    const int startIndex = cellIndex(m_startX, m_startY);
+
+    int current = cellIndex(m_endX, m_endY);
+    path.push_back(cellPoint(current));
+    for (int step = m_waveStep; step > 0 && current != startIndex; step--) {
+        const int previousStep = (step - 1) & 3;
+        int d = 0;
+        for (; d < 4; d++) {
+            int next = current + offsets[d];
+            size_t tile = bitTile(next);
+            uint64_t bit = bitMask(next);
+            int nextStep = (m_stepLowBits[tile] & bit ? 1 : 0) | (m_stepHighBits[tile] & bit ? 2 : 0);
+            if ((m_visitedBits[tile] & bit) && nextStep == previousStep)
+                break;
+        }
+        if (d == 4)
+            break;
+
+        current += offsets[d];
+        path.push_back(cellPoint(current));
+    }
+    std::reverse(path.begin(), path.end());
+}
+
+// fills m_waveMatrix in up to the current level with the plain wave, only levels not filled in before are expanded
+void PathFinder::syncBitboardWave() {
+    const int offsets[4] = { -m_stride, 1, m_stride, -1 };
+    while (m_syncStep < m_waveStep && !m_syncWave.empty()) {
+        m_wave.clear();
+        for (int current : m_syncWave) {
+            for (int d = 0; d < 4; d++) {
+                int next = current + offsets[d];
+                if (m_map[next] == MapCell::WALL || m_waveMatrix[next] != -1)
+                    continue;
+
+                m_waveMatrix[next] = m_syncStep + 1;
+                markTouched(next);
+                m_wave.push_back(next);
+            }
+        }
+        m_syncWave.swap(m_wave);
+        m_syncStep++;
+    }
+}
\ No newline at end of file
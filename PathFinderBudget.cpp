@@ -0,0 +1,98 @@
+#include "PathFinder.h"
+#include <algorithm>
+
+/*
+budgeted and background search
+processFor() hands out work in slices of cells. WAVE keeps a cursor into the level it is expanding,
+so it stops after any cell and goes on from there; ASTAR, JPS and WEIGHTED stop in the middle of a
+bucket and pop the rest of it next time. The other engines expand a whole level per slice.
+a time budget is checked between slices of BUDGET_SLICE_CELLS cells, so the clock is read only
+every few tens of microseconds.
+
+processAsync() runs the same slices on its own thread and checks the cancel flag between them.
+*/
+
+// cells expanded between two looks at the clock or the cancel flag
+static const long long BUDGET_SLICE_CELLS = 4096;
+
+long long PathFinder::processCells(long long maxCells) {
+    if (m_reachedPoint || m_oldWave.empty())
+        return 0;
+
+    SearchMode mode = activeSearchMode();
+    if (mode != SearchMode::WAVE && mode != SearchMode::ASTAR && mode != SearchMode::JPS && mode != SearchMode::WEIGHTED) {
+        long long frontier = mode == SearchMode::BITBOARD ? m_bitFrontierCells : (long long)m_oldWave.size();
+        processStep();
+        return frontier;
+    }
+
+#if defined(PATH_FINDER_STATS)
+    std::chrono::steady_clock::time_point stepStart = std::chrono::steady_clock::now();
+    // cells of the next level that earlier slices already labelled
+    size_t labelledBefore = m_waveCursor != 0 ? m_wave.size() : 0;
+#endif
+
+    long long expanded;
+    if (mode == SearchMode::WAVE)
+        expanded = processWaveStep(maxCells);
+    else if (mode == SearchMode::JPS)
+        expanded = processJumpPointStep(maxCells);
+    else
+        expanded = processAStarStep(maxCells);
+
+#if defined(PATH_FINDER_STATS)
+    size_t labelled = m_oldWave.size();
+    if (mode == SearchMode::WAVE)
+        labelled = (m_waveCursor != 0 ? m_wave.size() : m_oldWave.size()) - labelledBefore;
+    recordStep(stepStart, (int)expanded, (int)labelled);
+#endif
+    return expanded;
+}
+
+// calculates the path once the search is over, false while it still has work left
+bool PathFinder::finishBudgetedSearch() {
+    if (!m_reachedPoint && !m_oldWave.empty())
+        return false;
+
+    calculatePath(m_finalPath);
+#if defined(PATH_FINDER_STATS)
+    recordPath(m_finalPath.size());
+#endif
+    return true;
+}
+
+bool PathFinder::processFor(long long maxCells) {
+    while (maxCells > 0 && !m_reachedPoint && !m_oldWave.empty())
+        maxCells -= std::max(1LL, processCells(maxCells));
+    return finishBudgetedSearch();
+}
+
+bool PathFinder::processFor(std::chrono::microseconds maxTime) {
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + maxTime;
+    while (!m_reachedPoint && !m_oldWave.empty()) {
+        processCells(BUDGET_SLICE_CELLS);
+        if (std::chrono::steady_clock::now() >= deadline)
+            break;
+    }
+    return finishBudgetedSearch();
+}
+
+std::future<bool> PathFinder::processAsync() {
+    cancel();
+    m_cancelRequested = false;
+
+    std::promise<bool> finished;
+    std::future<bool> result = finished.get_future();
+    m_asyncThread = std::thread([this, finished = std::move(finished)]() mutable {
+        while (!m_cancelRequested.load(std::memory_order_relaxed) && !m_reachedPoint && !m_oldWave.empty())
+            processCells(BUDGET_SLICE_CELLS);
+        finished.set_value(finishBudgetedSearch());
+    });
+    return result;
+}
+
+void PathFinder::cancel() {
+    m_cancelRequested = true;
+    if (m_asyncThread.joinable())
+        m_asyncThread.join();
+}
\ No newline at end of file
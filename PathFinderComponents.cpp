@@ -0,0 +1,365 @@
+#include "PathFinder.h"
+#include "PathFinderNeighbourhood.h"
+#include "ThreadPool.h"
+#include <algorithm>
+
+/*
+connected components
+a search towards an END that can't be reached floods everything reachable from START before it
+gives up. With components built, reset() compares the ids of START and END and ends such a search
+at once.
+
+buildComponents() is a union-find over the padded grid. Every worker takes a band of rows and joins
+each free cell with its neighbours before it in the band, the roots always being the lowest index
+of their set, so a band never touches cells of another. The seams between the bands are joined
+afterwards, and one pass in index order turns the roots into dense ids - a parent always comes
+before its cell, so its id is known by then.
+
+edits update the ids one cell at a time:
+- a freed cell joins the components around it, the largest keeps its id and the others are relabelled.
+- a new wall can only split its component if its neighbours of that component are no longer connected
+  inside the 3 x 3 window around it. Then one search per group of neighbours runs in lockstep, two that
+  meet are the same part. When all parts but one are complete, those get new ids and the last keeps
+  the old one, so a split costs the size of the smaller parts, not of the component.
+*/
+
+// cells a band should have before it is worth another worker
+static const int COMPONENT_BAND_CELLS = 1 << 16;
+// cells every part of a split expands before the next one takes its turn
+static const int COMPONENT_SPLIT_TURN = 64;
+
+void PathFinder::buildComponents() {
+    if (m_mapSize == 0)
+        return;
+
+    switch (m_neighbourhood) {
+    case Neighbourhood::EIGHT:
+        buildComponents<EightNeighbours>();
+        break;
+    case Neighbourhood::EIGHT_NO_CORNER_CUTTING:
+        buildComponents<EightNeighboursNoCornerCutting>();
+        break;
+    case Neighbourhood::HEX:
+        buildComponents<HexNeighbours>();
+        break;
+    default:
+    case Neighbourhood::FOUR:
+        buildComponents<FourNeighbours>();
+        break;
+    }
+}
+
+template<class Neighbours>
+void PathFinder::buildComponents() {
+    const MapCell* map = m_map;
+    const int stride = m_stride;
+    std::vector<int>& parent = m_components;
+    parent.assign(m_mapSize, -1);
+
+    auto find = [&](int index) {
+        while (parent[index] != index) {
+            parent[index] = parent[parent[index]];
+            index = parent[index];
+        }
+        return index;
+    };
+    auto unite = [&](int a, int b) {
+        a = find(a);
+        b = find(b);
+        if (a < b)
+            parent[b] = a;
+        else if (b < a)
+            parent[a] = b;
+    };
+    // neighbours before the cell in index order, those on the row above only if upwards is set
+    auto uniteBefore = [&](int index, bool upwards) {
+        visitDirections<Neighbours>([&](auto direction) {
+            constexpr int d = decltype(direction)::value;
+            constexpr int dx = Neighbours::DX[d], dy = Neighbours::DY[d];
+            if constexpr (dy < 0 || (dy == 0 && dx < 0)) {
+                int next = index + dy * stride + dx;
+                if ((dy == 0 || upwards) && map[next] != MapCell::WALL && passesCorner<Neighbours, d>(map, index, stride))
+                    unite(index, next);
+            }
+            return false;
+        });
+    };
+
+    if (!m_threadPool)
+        m_threadPool = std::make_unique<ThreadPool>(m_threadCount);
+    const int bands = std::clamp((int)((long long)m_mapHeight * stride / COMPONENT_BAND_CELLS), 1, std::min(m_mapHeight, m_threadPool->getThreadCount()));
+    auto bandRow = [&](int band) { return 1 + (int)((long long)m_mapHeight * band / bands); };
+
+    m_threadPool->run([&](int band) {
+        for (int y = bandRow(band); y < bandRow(band + 1); y++) {
+            for (int index = y * stride + 1; index <= y * stride + m_mapWidth; index++) {
+                if (map[index] == MapCell::WALL)
+                    continue;
+                parent[index] = index;
+                uniteBefore(index, y != bandRow(band));
+            }
+        }
+    }, bands);
+
+    // the first row of every band but the first joins the row above
+    for (int band = 1; band < bands; band++) {
+        int y = bandRow(band);
+        for (int index = y * stride + 1; index <= y * stride + m_mapWidth; index++) {
+            if (map[index] != MapCell::WALL)
+                uniteBefore(index, true);
+        }
+    }
+
+    m_componentSizes.clear();
+    m_freeComponents.clear();
+    for (size_t index = 0; index < m_mapSize; index++) {
+        int next = parent[index];
+        if (next == -1)
+            continue;
+        if (next == (int)index) {
+            parent[index] = (int)m_componentSizes.size();
+            m_componentSizes.push_back(0);
+        }
+        else
+            parent[index] = parent[next];
+        m_componentSizes[parent[index]]++;
+    }
+}
+
+int PathFinder::getComponent(int x, int y) {
+    if (m_components.empty() || x < 0 || y < 0 || x >= m_mapWidth || y >= m_mapHeight)
+        return -1;
+    return m_components[cellIndex(x, y)];
+}
+
+bool PathFinder::isConnected(int x1, int y1, int x2, int y2) {
+    int component = getComponent(x1, y1);
+    return component != -1 && component == getComponent(x2, y2);
+}
+
+int PathFinder::newComponent() {
+    if (m_freeComponents.empty()) {
+        m_componentSizes.push_back(0);
+        return (int)m_componentSizes.size() - 1;
+    }
+    int component = m_freeComponents.back();
+    m_freeComponents.pop_back();
+    return component;
+}
+
+void PathFinder::releaseComponent(int component) {
+    m_componentSizes[component] = 0;
+    m_freeComponents.push_back(component);
+}
+
+void PathFinder::updateComponents(int index, bool walled) {
+    if (m_components.empty())
+        return;
+
+    switch (m_neighbourhood) {
+    case Neighbourhood::EIGHT:
+        walled ? removeComponentCell<EightNeighbours>(index) : addComponentCell<EightNeighbours>(index);
+        break;
+    case Neighbourhood::EIGHT_NO_CORNER_CUTTING:
+        walled ? removeComponentCell<EightNeighboursNoCornerCutting>(index) : addComponentCell<EightNeighboursNoCornerCutting>(index);
+        break;
+    case Neighbourhood::HEX:
+        walled ? removeComponentCell<HexNeighbours>(index) : addComponentCell<HexNeighbours>(index);
+        break;
+    default:
+    case Neighbourhood::FOUR:
+        walled ? removeComponentCell<FourNeighbours>(index) : addComponentCell<FourNeighbours>(index);
+        break;
+    }
+}
+
+// gives every cell of component "from" that is connected to seed the id "to"
+template<class Neighbours>
+void PathFinder::relabelComponent(int seed, int from, int to) {
+    const int stride = m_stride;
+    m_componentQueue.clear();
+    m_componentQueue.push_back(seed);
+    m_components[seed] = to;
+    while (!m_componentQueue.empty()) {
+        int current = m_componentQueue.back();
+        m_componentQueue.pop_back();
+        visitDirections<Neighbours>([&](auto direction) {
+            constexpr int d = decltype(direction)::value;
+            int next = current + Neighbours::DY[d] * stride + Neighbours::DX[d];
+            if (m_components[next] == from && m_map[next] != MapCell::WALL && passesCorner<Neighbours, d>(m_map, current, stride)) {
+                m_components[next] = to;
+                m_componentQueue.push_back(next);
+            }
+            return false;
+        });
+    }
+}
+
+template<class Neighbours>
+void PathFinder::addComponentCell(int index) {
+    const int stride = m_stride;
+    // the components around the cell and a cell of each
+    int components[Neighbours::COUNT], seeds[Neighbours::COUNT];
+    int count = 0;
+    visitDirections<Neighbours>([&](auto direction) {
+        constexpr int d = decltype(direction)::value;
+        int next = index + Neighbours::DY[d] * stride + Neighbours::DX[d];
+        int component = m_components[next];
+        if (component == -1 || m_map[next] == MapCell::WALL || !passesCorner<Neighbours, d>(m_map, index, stride))
+            return false;
+        if (std::find(components, components + count, component) == components + count) {
+            components[count] = component;
+            seeds[count++] = next;
+        }
+        return false;
+    });
+
+    if (count == 0) {
+        m_components[index] = newComponent();
+        m_componentSizes[m_components[index]] = 1;
+        return;
+    }
+
+    int largest = 0;
+    for (int i = 1; i < count; i++) {
+        if (m_componentSizes[components[i]] > m_componentSizes[components[largest]])
+            largest = i;
+    }
+    int target = components[largest];
+    for (int i = 0; i < count; i++) {
+        if (i == largest)
+            continue;
+        relabelComponent<Neighbours>(seeds[i], components[i], target);
+        m_componentSizes[target] += m_componentSizes[components[i]];
+        releaseComponent(components[i]);
+    }
+    m_components[index] = target;
+    m_componentSizes[target]++;
+}
+
+template<class Neighbours>
+void PathFinder::removeComponentCell(int index) {
+    const int stride = m_stride;
+    const int component = m_components[index];
+    if (component == -1)
+        return;
+    m_components[index] = -1;
+    if (--m_componentSizes[component] == 0) {
+        releaseComponent(component);
+        return;
+    }
+
+    // joins the cells of the component inside the window, windowParent is indexed by (dy + 1) * 3 + dx + 1
+    int windowParent[9];
+    auto windowFind = [&](int cell) {
+        while (windowParent[cell] != cell)
+            cell = windowParent[cell];
+        return cell;
+    };
+    for (int cell = 0; cell < 9; cell++)
+        windowParent[cell] = cell;
+    for (int cell = 0; cell < 9; cell++) {
+        int cellX = cell % 3 - 1, cellY = cell / 3 - 1;
+        int from = index + cellY * stride + cellX;
+        if (cell == 4 || m_components[from] != component || m_map[from] == MapCell::WALL)
+            continue;
+        visitDirections<Neighbours>([&](auto direction) {
+            constexpr int d = decltype(direction)::value;
+            int nextX = cellX + Neighbours::DX[d], nextY = cellY + Neighbours::DY[d];
+            int next = from + Neighbours::DY[d] * stride + Neighbours::DX[d];
+            if (nextX < -1 || nextX > 1 || nextY < -1 || nextY > 1 || (nextX == 0 && nextY == 0))
+                return false;
+            if (m_components[next] == component && m_map[next] != MapCell::WALL && passesCorner<Neighbours, d>(m_map, from, stride))
+                windowParent[windowFind(cell)] = windowFind((nextY + 1) * 3 + nextX + 1);
+            return false;
+        });
+    }
+
+    // one neighbour per group of neighbours the window doesn't connect
+    int seeds[Neighbours::COUNT], groups[Neighbours::COUNT];
+    int count = 0;
+    visitDirections<Neighbours>([&](auto direction) {
+        constexpr int d = decltype(direction)::value;
+        int next = index + Neighbours::DY[d] * stride + Neighbours::DX[d];
+        if (m_components[next] != component || m_map[next] == MapCell::WALL)
+            return false;
+        int group = windowFind((Neighbours::DY[d] + 1) * 3 + Neighbours::DX[d] + 1);
+        if (std::find(groups, groups + count, group) == groups + count) {
+            groups[count] = group;
+            seeds[count++] = next;
+        }
+        return false;
+    });
+    if (count < 2)
+        return;
+
+    struct Part {
+        int component;
+        std::vector<int> cells;	// visited cells, the ones from head on are still to be expanded
+        size_t head;
+        bool merged;
+    };
+    std::vector<Part> parts(count);
+    for (int i = 0; i < count; i++) {
+        parts[i] = { newComponent(), { seeds[i] }, 0, false };
+        m_components[seeds[i]] = parts[i].component;
+    }
+
+    int open = count;
+    while (open > 1) {
+        for (Part& part : parts) {
+            if (part.merged || part.head == part.cells.size())
+                continue;
+
+            for (int turn = 0; turn < COMPONENT_SPLIT_TURN && part.head < part.cells.size(); turn++) {
+                int current = part.cells[part.head++];
+                visitDirections<Neighbours>([&](auto direction) {
+                    constexpr int d = decltype(direction)::value;
+                    int next = current + Neighbours::DY[d] * stride + Neighbours::DX[d];
+                    int nextComponent = m_components[next];
+                    if (nextComponent == -1 || nextComponent == part.component || m_map[next] == MapCell::WALL || !passesCorner<Neighbours, d>(m_map, current, stride))
+                        return false;
+
+                    if (nextComponent == component) {
+                        m_components[next] = part.component;
+                        part.cells.push_back(next);
+                        return false;
+                    }
+                    // met another part, both are the same piece
+                    for (Part& other : parts) {
+                        if (other.merged || other.component != nextComponent)
+                            continue;
+                        for (int cell : other.cells)
+                            m_components[cell] = part.component;
+                        part.cells.insert(part.cells.end(), other.cells.begin(), other.cells.end());
+                        releaseComponent(other.component);
+                        other.merged = true;
+                        open--;
+                    }
+                    return false;
+                });
+            }
+            if (part.head == part.cells.size())
+                open--;
+            if (open <= 1)
+                break;
+        }
+    }
+
+    // complete parts keep their new ids, the part still growing takes the old one back
+    for (Part& part : parts) {
+        if (part.merged)
+            continue;
+        if (part.head == part.cells.size()) {
+            m_componentSizes[part.component] = (int)part.cells.size();
+            m_componentSizes[component] -= (int)part.cells.size();
+        }
+        else {
+            for (int cell : part.cells)
+                m_components[cell] = component;
+            releaseComponent(part.component);
+        }
+    }
+    if (m_componentSizes[component] == 0)
+        releaseComponent(component);
+}
\ No newline at end of file
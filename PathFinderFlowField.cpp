@@ -0,0 +1,179 @@
+#include "PathFinder.h"
+#include "PathFinderNeighbourhood.h"
+#include <climits>
+
+/*
+flow field towards a shared goal
+the field is a wave grown backwards from END: a cell's distance is the cost of its way to the goal
+and its direction points at the neighbour that way continues with. Agents only read the field.
+
+moving the goal from G to G' changes every distance by at most k, the cost of the way from G to G'.
+so distance + k is still an upper bound for every cell, and lowering those bounds from G' on gives
+the new field: cells that end up exactly k further keep their direction, the cell they point at
+is exactly k further as well, only cells that get relatively closer to G' are visited.
+raising all distances by k is a single add to m_flowOffset.
+*/
+
+static const int FLOW_UNREACHED = INT_MAX;
+// the offset only grows with goal moves, a full flood starts it over long before the distances could overflow
+static const int FLOW_OFFSET_LIMIT = 1 << 30;
+
+bool PathFinder::buildFlowField() {
+    if (m_mapSize == 0)
+        return false;
+
+    m_flowDirections.assign(m_mapSize, FLOW_NONE);
+    m_flowDistances.assign(m_mapSize, FLOW_UNREACHED);
+    m_flowOffset = 0;
+    m_flowGoal = cellIndex(m_endX, m_endY);
+    // as with the forward wave, an END on a wall can't be reached
+    if (m_map[m_flowGoal] != MapCell::WALL) {
+        m_flowDistances[m_flowGoal] = 0;
+        propagateFlowField(-1);
+    }
+    return true;
+}
+
+bool PathFinder::moveFlowGoal(int x, int y) {
+    if (m_flowGoal != -1 && m_flowGoal == cellIndex(x, y))
+        return true;
+    if (!setEndpoints(m_startX, m_startY, x, y))
+        return false;
+
+    int goal = cellIndex(x, y);
+    if (m_flowGoal == -1 || m_flowDistances[goal] == FLOW_UNREACHED || m_map[goal] == MapCell::WALL)
+        return buildFlowField();
+
+    // the field holds the way from G' to G, walked the other way round it enters G' instead of G
+    const uint8_t* costs = m_neighbourhood == Neighbourhood::FOUR ? costData() : nullptr;
+    int moveCost = m_flowDistances[goal] + m_flowOffset;
+    if (costs)
+        moveCost += costs[goal] - costs[m_flowGoal];
+    if (m_flowOffset + moveCost > FLOW_OFFSET_LIMIT)
+        return buildFlowField();
+
+    int previousGoal = m_flowGoal;
+    m_flowOffset += moveCost;
+    m_flowGoal = goal;
+    m_flowDistances[goal] = -m_flowOffset;
+    m_flowDirections[goal] = FLOW_NONE;
+    propagateFlowField(previousGoal);
+    return true;
+}
+
+bool PathFinder::getFlowMove(int x, int y, int& nextX, int& nextY) {
+    if (m_flowGoal == -1 || x < 0 || y < 0 || x >= m_mapWidth || y >= m_mapHeight)
+        return false;
+
+    int index = cellIndex(x, y);
+    if (m_flowDirections[index] == FLOW_NONE)
+        return false;
+
+    std::pair<int, int> next = cellPoint(index + m_flowSteps[m_flowDirections[index]]);
+    nextX = next.first;
+    nextY = next.second;
+    return true;
+}
+
+int PathFinder::getFlowDistance(int x, int y) {
+    if (m_flowGoal == -1 || x < 0 || y < 0 || x >= m_mapWidth || y >= m_mapHeight)
+        return -1;
+
+    int distance = m_flowDistances[cellIndex(x, y)];
+    return distance == FLOW_UNREACHED ? -1 : distance + m_flowOffset;
+}
+
+PathFinder::GridView<uint8_t> PathFinder::getFlowFieldView() {
+    if (m_flowGoal == -1)
+        return { nullptr, 0, 0, m_stride };
+    return { m_flowDirections.data() + m_stride + 1, m_mapWidth, m_mapHeight, m_stride };
+}
+
+void PathFinder::propagateFlowField(int previousGoal) {
+    // costs only exist for four neighbours
+    const uint8_t* costs = m_neighbourhood == Neighbourhood::FOUR ? costData() : nullptr;
+    switch (m_neighbourhood) {
+    case Neighbourhood::EIGHT:
+        propagateFlowField<EightNeighbours>(costs, previousGoal);
+        break;
+    case Neighbourhood::EIGHT_NO_CORNER_CUTTING:
+        propagateFlowField<EightNeighboursNoCornerCutting>(costs, previousGoal);
+        break;
+    case Neighbourhood::HEX:
+        propagateFlowField<HexNeighbours>(costs, previousGoal);
+        break;
+    default:
+    case Neighbourhood::FOUR:
+        propagateFlowField<FourNeighbours>(costs, previousGoal);
+        break;
+    }
+}
+
+template<class Neighbours>
+void PathFinder::propagateFlowField(const uint8_t* costs, int previousGoal) {
+    const MapCell* map = m_map;
+    const int stride = m_stride;
+    int* distances = m_flowDistances.data();
+    uint8_t* directions = m_flowDirections.data();
+
+    visitDirections<Neighbours>([&](auto direction) {
+        constexpr int d = decltype(direction)::value;
+        m_flowSteps[d] = Neighbours::DY[d] * stride + Neighbours::DX[d];
+        return false;
+    });
+
+    // buckets by distance, a step costs at most MAX_CELL_COST so pushes never wrap onto the current bucket
+    const int bucketCount = MAX_CELL_COST + 1;
+    m_flowBuckets.resize(bucketCount);
+    for (std::vector<int>& bucket : m_flowBuckets)
+        bucket.clear();
+
+    int current = 0;
+    long long pending = 1;
+    m_flowBuckets[0].push_back(m_flowGoal);
+    while (pending > 0) {
+        std::vector<int>& bucket = m_flowBuckets[current % bucketCount];
+        if (bucket.empty()) {
+            current++;
+            continue;
+        }
+
+        int cell = bucket.back();
+        bucket.pop_back();
+        pending--;
+        // skip cells that were lowered again since they were pushed
+        if (distances[cell] + m_flowOffset != current)
+            continue;
+
+        // the neighbours step into this cell
+        int enterCost = costs ? costs[cell] : 1;
+        int lowered = current + enterCost - m_flowOffset;
+        visitDirections<Neighbours>([&](auto direction) {
+            constexpr int d = decltype(direction)::value;
+            int next = cell + Neighbours::DY[d] * stride + Neighbours::DX[d];
+            if (map[next] == MapCell::WALL || distances[next] <= lowered || !passesCorner<Neighbours, d>(map, cell, stride))
+                return false;
+
+            distances[next] = lowered;
+            directions[next] = (uint8_t)oppositeDirection<Neighbours, d>();
+            m_flowBuckets[(current + enterCost) % bucketCount].push_back(next);
+            pending++;
+            return false;
+        });
+    }
+
+    // the old goal keeps its bound if it didn't get closer, any neighbour that the bound goes through will do
+    if (previousGoal == -1 || directions[previousGoal] != FLOW_NONE)
+        return;
+    visitDirections<Neighbours>([&](auto direction) {
+        constexpr int d = decltype(direction)::value;
+        int next = previousGoal + Neighbours::DY[d] * stride + Neighbours::DX[d];
+        if (map[next] == MapCell::WALL || distances[next] == FLOW_UNREACHED || !passesCorner<Neighbours, d>(map, previousGoal, stride))
+            return false;
+        if ((long long)distances[next] + (costs ? costs[next] : 1) != distances[previousGoal])
+            return false;
+
+        directions[previousGoal] = (uint8_t)d;
+        return true;
+    });
+}
\ No newline at end of file
@@ -0,0 +1,252 @@
+#include "PathFinder.h"
+#include <algorithm>
+#include <cstdlib>
+
+/*
+A* and jump point search
+both keep g in m_waveMatrix and the open cells in a ring of buckets indexed by f = g + h.
+every bucket is a linked list through one shared entry pool, so a warmed up search doesn't allocate.
+Manhattan distance is consistent on a 4-connected grid, so f never decreases and the queue
+only walks forward through the ring - no binary heap. Within a bucket cells are taken LIFO,
+which prefers the deepest cells and heads straight for END on open maps.
+one processStep() expands the whole lowest bucket.
+SearchMode::WEIGHTED is the same queue with h = 0 over cell costs (Dial's algorithm), and
+ASTAR adds the cost of the entered cell instead of 1 while costs are set.
+
+jump point search skips the straight runs in between: vertical moves may turn at any cell,
+horizontal moves only where a wall behind them opens up (a forced neighbour). Every shortest
+path has an equally long one of that shape, so only the cells where such paths turn become nodes.
+the horizontal jumps are looked up in a table built once per map, a vertical jump asks both of
+them at every cell it passes and would otherwise scan whole rows there.
+
+with landmarks (PathFinderLandmarks.cpp) h is the larger of Manhattan and the landmark bound.
+both change by at most one per step, so h stays consistent and the ring keeps its span.
+*/
+
+// up, right, down, left - the same order as the wave offsets
+static const int DIRECTION_DX[4] = { 0, 1, 0, -1 };
+static const int DIRECTION_DY[4] = { -1, 0, 1, 0 };
+
+int PathFinder::heuristic(int index) const {
+    // Dijkstra order for WEIGHTED and for floods
+    if (m_floodAll || m_searchMode == SearchMode::WEIGHTED)
+        return 0;
+    int manhattan = std::abs(index % m_stride - (m_endX + 1)) + std::abs(index / m_stride - (m_endY + 1));
+    if (m_landmarks.empty())
+        return manhattan;
+    return std::max(manhattan, landmarkBound(index, cellIndex(m_endX, m_endY)));
+}
+
+void PathFinder::pushOpen(int index, int g) {
+    int& head = m_bucketHeads[(g + heuristic(index)) & m_bucketMask];
+    m_openEntries.push_back({ index, head });
+    head = (int)m_openEntries.size() - 1;
+    m_openCount++;
+}
+
+// takes the open cell with the lowest f, -1 once the queue is empty
+int PathFinder::popOpen() {
+    while (m_openCount > 0) {
+        int& head = m_bucketHeads[m_currentF & m_bucketMask];
+        if (head == -1) {
+            m_currentF++;
+            continue;
+        }
+
+        int index = m_openEntries[head].first;
+        head = m_openEntries[head].second;
+        m_openCount--;
+        // skip cells that were closed or got a better g since they were pushed
+        if (!m_closed[index] && m_waveMatrix[index] + heuristic(index) == m_currentF)
+            return index;
+    }
+    return -1;
+}
+
+void PathFinder::resetHeuristic() {
+    // a single move raises f by at most twice its length, so the open f values always fit in the ring
+    int span = 2 * (m_mapWidth + m_mapHeight) + 4;
+    // with costs a move raises f by at most its cost plus one
+    if (isWeighted())
+        span = std::max(span, 2 * (MAX_CELL_COST + 1));
+    int bucketCount = 4;
+    while (bucketCount < span)
+        bucketCount *= 2;
+
+    m_bucketHeads.assign(bucketCount, -1);
+    m_openEntries.clear();
+    m_bucketMask = bucketCount - 1;
+    m_openCount = 0;
+    // reset() has cleared the cells the last search touched, the buffers are only filled when they're new
+    if (m_closed.size() != m_mapSize)
+        m_closed.assign(m_mapSize, 0);
+
+    if (m_searchMode == SearchMode::JPS && m_jumpParent.size() != m_mapSize) {
+        m_jumpParent.assign(m_mapSize, -1);
+        m_jumpDirection.assign(m_mapSize, -1);
+    }
+    if (activeSearchMode() == SearchMode::JPS && m_jumpRight.size() != m_mapSize)
+        buildJumpTable();
+
+    int startIndex = cellIndex(m_startX, m_startY);
+    m_currentF = heuristic(startIndex);
+    pushOpen(startIndex, 0);
+}
+
+long long PathFinder::processAStarStep(long long maxCells) {
+    const int offsets[4] = { -m_stride, 1, m_stride, -1 };
+    const int endIndex = targetIndex();
+    const uint8_t* costs = isWeighted() ? costData() : nullptr;
+
+    m_wave.clear();
+    int current;
+    while ((current = popOpen()) != -1) {
+        m_closed[current] = 1;
+        m_wave.push_back(current);
+        if (current == endIndex) {
+            m_reachedPoint = true;
+            break;
+        }
+
+        for (int d = 0; d < 4; d++) {
+            int next = current + offsets[d];
+            if (m_map[next] == MapCell::WALL)
+                continue;
+
+            int nextG = m_waveMatrix[current] + (costs ? costs[next] : 1);
+            if (m_waveMatrix[next] != -1 && m_waveMatrix[next] <= nextG)
+                continue;
+
+            m_waveMatrix[next] = nextG;
+            markTouched(next);
+            pushOpen(next, nextG);
+        }
+
+        // one step expands the cells of one f value, a budget may stop it earlier and the next step
+        // goes on with the same bucket
+        if (m_bucketHeads[m_currentF & m_bucketMask] == -1 || (long long)m_wave.size() >= maxCells)
+            break;
+    }
+
+    m_waveStep++;
+    m_oldWave.swap(m_wave);
+    return (long long)m_oldWave.size();
+}
+
+// one pass per row and direction, every cell stops where its neighbour stops unless the neighbour itself ends the jump
+void PathFinder::buildJumpTable() {
+    m_jumpRight.resize(m_mapSize);
+    m_jumpLeft.resize(m_mapSize);
+
+    // a wall behind an open cell above or below means no vertical move could have reached it earlier
+    auto stopsJump = [&](int index, int dx) {
+        if (m_map[index] == MapCell::WALL)
+            return true;
+        bool forcedUp = m_map[index - m_stride] != MapCell::WALL && m_map[index - dx - m_stride] == MapCell::WALL;
+        bool forcedDown = m_map[index + m_stride] != MapCell::WALL && m_map[index - dx + m_stride] == MapCell::WALL;
+        return forcedUp || forcedDown;
+    };
+
+    for (int y = 0; y < m_mapHeight; y++) {
+        const int first = cellIndex(0, y), last = cellIndex(m_mapWidth - 1, y);
+        for (int index = last; index >= first; index--)
+            m_jumpRight[index] = stopsJump(index + 1, 1) ? index + 1 : m_jumpRight[index + 1];
+        for (int index = first; index <= last; index++)
+            m_jumpLeft[index] = stopsJump(index - 1, -1) ? index - 1 : m_jumpLeft[index - 1];
+    }
+}
+
+// first jump point met moving horizontally from index, -1 if a wall comes first
+int PathFinder::jumpHorizontal(int index, int dx) const {
+    int stop = dx > 0 ? m_jumpRight[index] : m_jumpLeft[index];
+    // END ends the jump wherever it lies on the run, the table doesn't know it
+    const int endIndex = cellIndex(m_endX, m_endY);
+    if (dx > 0 ? endIndex > index && endIndex < stop : endIndex < index && endIndex > stop)
+        return endIndex;
+    return m_map[stop] == MapCell::WALL ? -1 : stop;
+}
+
+// first jump point met moving vertically from index, -1 if a wall comes first
+int PathFinder::jumpVertical(int index, int dy) const {
+    const int endIndex = cellIndex(m_endX, m_endY);
+    const int offset = dy * m_stride;
+    while (true) {
+        index += offset;
+        if (m_map[index] == MapCell::WALL)
+            return -1;
+        if (index == endIndex)
+            return index;
+
+        // vertical moves may turn at any cell, so a cell with a horizontal jump point is a turning point
+        if (jumpHorizontal(index, 1) != -1 || jumpHorizontal(index, -1) != -1)
+            return index;
+    }
+}
+
+long long PathFinder::processJumpPointStep(long long maxCells) {
+    const int endIndex = cellIndex(m_endX, m_endY);
+
+    m_wave.clear();
+    int current;
+    while ((current = popOpen()) != -1) {
+        m_closed[current] = 1;
+        m_wave.push_back(current);
+        if (current == endIndex) {
+            m_reachedPoint = true;
+            break;
+        }
+
+        // a jump point may be reached from several sides with the same g and only the first one is kept,
+        // so it branches into every direction but straight back, where all cells are closer to START
+        int arrival = m_jumpDirection[current];
+        for (int d = 0; d < 4; d++) {
+            int dx = DIRECTION_DX[d], dy = DIRECTION_DY[d];
+            if (arrival != -1 && d == (arrival + 2) % 4)
+                continue;
+
+            int jumpPoint = dx != 0 ? jumpHorizontal(current, dx) : jumpVertical(current, dy);
+            if (jumpPoint == -1)
+                continue;
+
+            int distance = std::abs(jumpPoint - current) / (dx != 0 ? 1 : m_stride);
+            int nextG = m_waveMatrix[current] + distance;
+            if (m_waveMatrix[jumpPoint] != -1 && m_waveMatrix[jumpPoint] <= nextG)
+                continue;
+
+            m_waveMatrix[jumpPoint] = nextG;
+            markTouched(jumpPoint);
+            m_jumpParent[jumpPoint] = current;
+            m_jumpDirection[jumpPoint] = (int8_t)d;
+            pushOpen(jumpPoint, nextG);
+        }
+
+        if (m_bucketHeads[m_currentF & m_bucketMask] == -1 || (long long)m_wave.size() >= maxCells)
+            break;
+    }
+
+    m_waveStep++;
+    m_oldWave.swap(m_wave);
+    return (long long)m_oldWave.size();
+}
+
+// follows the jump point parents from END and fills in the straight runs between them
+void PathFinder::calculateJumpPath(std::vector<std::pair<int, int>>& path) {
+    const int startIndex = cellIndex(m_startX, m_startY);
+    int current = cellIndex(m_endX, m_endY);
+    path.push_back(cellPoint(current));
+
+    while (current != startIndex) {
+        int parent = m_jumpParent[current];
+        if (parent == -1)
+            break;
+
+        int step = std::abs(parent - current) < m_stride ? 1 : m_stride;
+        if (parent < current)
+            step = -step;
+        for (int index = current + step; index != parent; index += step)
+            path.push_back(cellPoint(index));
+        path.push_back(cellPoint(parent));
+        current = parent;
+    }
+    std::reverse(path.begin(), path.end());
+}
\ No newline at end of file
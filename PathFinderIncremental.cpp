@@ -0,0 +1,161 @@
+#include "PathFinder.h"
+#include <queue>
+#include <functional>
+
+/*
+incremental repair of a full flood after map edits
+1. cells that became walls lose their step. Walking outwards in order of the old steps, a cell
+   whose neighbours no longer hold a valid step - 1 lost its last shortest path to START and
+   is invalidated as well.
+2. invalidated and freed cells are seeded with the best step their labelled neighbours offer
+   and the steps are spread again from there. A freed cell may also shorten the way to cells
+   that kept their step, those are lowered by the same propagation.
+only cells whose step actually changes are ever pushed to a queue.
+*/
+
+void PathFinder::setCell(int x, int y, MapCell cell) {
+    setCells({ { x, y, cell } });
+}
+
+void PathFinder::setCells(const std::vector<CellEdit>& edits) {
+    if (m_mapSize == 0)
+        return;
+    detachSharedMap();
+
+    std::vector<int> walledCells, freedCells;
+    bool startChanged = false;
+
+    for (const CellEdit& edit : edits) {
+        if (edit.x < 0 || edit.y < 0 || edit.x >= m_mapWidth || edit.y >= m_mapHeight) {
+            log("setCells: cell is outside of the map");
+            continue;
+        }
+
+        int index = cellIndex(edit.x, edit.y);
+        MapCell oldCell = m_map[index];
+        if (oldCell == edit.cell)
+            continue;
+
+        if (index == cellIndex(m_startX, m_startY) || edit.cell == MapCell::START)
+            startChanged = true;
+
+        // START and END are unique, the old marker is cleared when it moves
+        if (edit.cell == MapCell::START && m_map[cellIndex(m_startX, m_startY)] == MapCell::START)
+            m_map[cellIndex(m_startX, m_startY)] = MapCell::EMPTY;
+        else if (edit.cell == MapCell::END && m_map[cellIndex(m_endX, m_endY)] == MapCell::END)
+            m_map[cellIndex(m_endX, m_endY)] = MapCell::EMPTY;
+        storeCell(edit.x, edit.y, edit.cell);
+        // the free tiles of the bitboard engine follow the edit instead of being built again
+        if (!m_freeBits.empty()) {
+            if (edit.cell == MapCell::WALL)
+                m_freeBits[bitTile(index)] &= ~bitMask(index);
+            else
+                m_freeBits[bitTile(index)] |= bitMask(index);
+        }
+
+        if (oldCell == MapCell::WALL) {
+            freedCells.push_back(index);
+            updateComponents(index, false);
+        }
+        else if (edit.cell == MapCell::WALL) {
+            walledCells.push_back(index);
+            updateComponents(index, true);
+        }
+    }
+
+    if (!walledCells.empty() || !freedCells.empty()) {
+        m_flowGoal = -1;
+        m_landmarks.clear();
+        m_landmarkTable.clear();
+        m_jumpRight.clear();
+        m_jumpLeft.clear();
+    }
+
+    // the repair relies on unit steps over four neighbours in a dense matrix, anything else is flooded again
+    if (startChanged || !m_flooded || isWeighted() || m_neighbourhood != Neighbourhood::FOUR || m_waveStorage == WaveStorage::PAGED) {
+        processAll();
+        return;
+    }
+
+    repairWaveMatrix(walledCells, freedCells);
+    m_reachedPoint = m_waveMatrix[cellIndex(m_endX, m_endY)] != -1;
+    calculatePath(m_finalPath);
+}
+
+void PathFinder::repairWaveMatrix(const std::vector<int>& walledCells, const std::vector<int>& freedCells) {
+    const int offsets[4] = { -m_stride, 1, m_stride, -1 };
+    const int startIndex = cellIndex(m_startX, m_startY);
+    // freed cells may lie on pages the flood never touched
+    m_pagesTracked = false;
+
+    typedef std::pair<int, int> QueueEntry; // step, cell index
+    std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> queue;
+    std::vector<int> invalidated;
+
+    // 1. invalidate cells that lost every shortest path to START
+    for (int index : walledCells) {
+        int step = m_waveMatrix[index];
+        if (step == -1)
+            continue;
+        m_waveMatrix[index] = -1;
+        for (int d = 0; d < 4; d++) {
+            if (m_waveMatrix[index + offsets[d]] == step + 1)
+                queue.push({ step + 1, index + offsets[d] });
+        }
+    }
+
+    while (!queue.empty()) {
+        auto [step, index] = queue.top();
+        queue.pop();
+        // already invalidated or pushed from a cell of another level
+        if (m_waveMatrix[index] != step || index == startIndex)
+            continue;
+
+        bool hasParent = false;
+        for (int d = 0; d < 4 && !hasParent; d++)
+            hasParent = m_waveMatrix[index + offsets[d]] == step - 1;
+        if (hasParent)
+            continue;
+
+        m_waveMatrix[index] = -1;
+        invalidated.push_back(index);
+        for (int d = 0; d < 4; d++) {
+            if (m_waveMatrix[index + offsets[d]] == step + 1)
+                queue.push({ step + 1, index + offsets[d] });
+        }
+    }
+
+    // 2. seed invalidated and freed cells from their labelled neighbours and spread the steps again
+    auto seed = [&](int index) {
+        if (m_map[index] == MapCell::WALL)
+            return;
+        int best = -1;
+        for (int d = 0; d < 4; d++) {
+            int step = m_waveMatrix[index + offsets[d]];
+            if (step != -1 && (best == -1 || step + 1 < best))
+                best = step + 1;
+        }
+        if (best != -1)
+            queue.push({ best, index });
+    };
+    for (int index : invalidated)
+        seed(index);
+    for (int index : freedCells)
+        seed(index);
+
+    while (!queue.empty()) {
+        auto [step, index] = queue.top();
+        queue.pop();
+        if (m_waveMatrix[index] != -1 && m_waveMatrix[index] <= step)
+            continue;
+
+        m_waveMatrix[index] = step;
+        for (int d = 0; d < 4; d++) {
+            int next = index + offsets[d];
+            if (m_map[next] == MapCell::WALL)
+                continue;
+            if (m_waveMatrix[next] == -1 || m_waveMatrix[next] > step + 1)
+                queue.push({ step + 1, next });
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,265 @@
+#include "PathFinder.h"
+#include "PathFinderNeighbourhood.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cstdlib>
+
+/*
+landmarks (ALT)
+for a landmark L and any two cells a and b the triangle inequality gives
+steps(a, b) >= |steps(L, a) - steps(L, b)|, so a table of full waves from a few landmarks bounds
+the distance between any two cells from below without a search. Every term changes by at most one
+per step, so the largest of them is a consistent heuristic and the bucket queue of
+PathFinderHeuristic.cpp keeps walking forward.
+
+the table stores 16-bit steps. A saturated distance only weakens the bound, never breaks it.
+it is cell-major, the distances of one cell to all landmarks lie next to each other, so the heuristic
+reads a single run of memory per cell instead of one cache line per landmark.
+
+FARTHEST picks every landmark from the wave of the ones before, so its floods run one after another.
+given landmarks - BORDER or setLandmarks() - are flooded in rounds on the worker pool, one landmark
+per worker into its own plane, and each round is copied into the table by cell ranges afterwards.
+*/
+
+bool PathFinder::buildLandmarks(int count, LandmarkSelection selection) {
+    count = std::min(count, MAX_LANDMARKS);
+    if (m_mapSize == 0 || count < 1) {
+        clearLandmarks();
+        return false;
+    }
+
+    int seed = cellIndex(m_startX, m_startY);
+    if (m_map[seed] == MapCell::WALL) {
+        seed = -1;
+        for (size_t index = 0; index < m_mapSize && seed == -1; index++) {
+            if (m_map[index] != MapCell::WALL)
+                seed = (int)index;
+        }
+    }
+    if (seed == -1) {
+        clearLandmarks();
+        return false;
+    }
+
+    m_landmarks.clear();
+    if (selection == LandmarkSelection::BORDER) {
+        // points evenly spaced around the border, each moved towards the centre until it is on a free cell
+        const int perimeter = std::max(1, 2 * (m_mapWidth + m_mapHeight) - 4);
+        const int centreX = m_mapWidth / 2, centreY = m_mapHeight / 2;
+        for (int i = 0; i < count; i++) {
+            int position = (int)((long long)perimeter * i / count);
+            int x, y;
+            if (position < m_mapWidth)
+                x = position, y = 0;
+            else if ((position -= m_mapWidth - 1) < m_mapHeight)
+                x = m_mapWidth - 1, y = position;
+            else if ((position -= m_mapHeight - 1) < m_mapWidth)
+                x = m_mapWidth - 1 - position, y = m_mapHeight - 1;
+            else
+                x = 0, y = std::max(0, m_mapHeight - 1 - (position - m_mapWidth + 1));
+
+            int steps = std::max(std::abs(centreX - x), std::abs(centreY - y));
+            for (int step = 0; step <= steps; step++) {
+                int index = cellIndex(x + (steps ? (centreX - x) * step / steps : 0), y + (steps ? (centreY - y) * step / steps : 0));
+                if (m_map[index] == MapCell::WALL)
+                    continue;
+                if (std::find(m_landmarks.begin(), m_landmarks.end(), index) == m_landmarks.end())
+                    m_landmarks.push_back(index);
+                break;
+            }
+        }
+        if (m_landmarks.empty())
+            m_landmarks.push_back(seed);
+        floodLandmarks();
+        reset();
+        return true;
+    }
+
+    // FARTHEST: nearest holds the steps to the closest landmark so far, the seed's wave picks the first one
+    std::vector<uint16_t> plane(m_mapSize), nearest(m_mapSize);
+    std::vector<int> wave, nextWave;
+    floodLandmark(seed, nearest.data(), wave, nextWave);
+    m_landmarkTable.assign(m_mapSize * count, LANDMARK_UNREACHABLE);
+
+    for (int landmark = 0; landmark < count; landmark++) {
+        int farthest = landmark == 0 ? seed : -1;
+        uint16_t farthestSteps = 0;
+        for (size_t index = 0; index < m_mapSize; index++) {
+            if (nearest[index] != LANDMARK_UNREACHABLE && nearest[index] > farthestSteps) {
+                farthest = (int)index;
+                farthestSteps = nearest[index];
+            }
+        }
+        // every reachable cell is a landmark already
+        if (farthest == -1)
+            break;
+
+        m_landmarks.push_back(farthest);
+        floodLandmark(farthest, plane.data(), wave, nextWave);
+        for (size_t index = 0; index < m_mapSize; index++) {
+            m_landmarkTable[index * count + landmark] = plane[index];
+            nearest[index] = landmark == 0 ? plane[index] : std::min(nearest[index], plane[index]);
+        }
+    }
+
+    // fewer landmarks than asked for, the rows are packed to the ones there are
+    const size_t placed = m_landmarks.size();
+    if (placed < (size_t)count) {
+        for (size_t index = 0; index < m_mapSize; index++)
+            std::copy_n(&m_landmarkTable[index * count], placed, &m_landmarkTable[index * placed]);
+        m_landmarkTable.resize(m_mapSize * placed);
+    }
+    reset();
+    return true;
+}
+
+bool PathFinder::setLandmarks(const std::vector<std::pair<int, int>>& cells) {
+    if (m_mapSize == 0 || cells.empty() || cells.size() > (size_t)MAX_LANDMARKS) {
+        log("setLandmarks: no landmarks or too many");
+        return false;
+    }
+
+    std::vector<int> landmarks;
+    for (auto [x, y] : cells) {
+        if (x < 0 || y < 0 || x >= m_mapWidth || y >= m_mapHeight || m_map[cellIndex(x, y)] == MapCell::WALL) {
+            log("setLandmarks: landmark is outside of the map or on a wall");
+            return false;
+        }
+        landmarks.push_back(cellIndex(x, y));
+    }
+
+    m_landmarks = std::move(landmarks);
+    floodLandmarks();
+    reset();
+    return true;
+}
+
+void PathFinder::clearLandmarks() {
+    bool hadLandmarks = !m_landmarks.empty();
+    m_landmarks.clear();
+    std::vector<uint16_t>().swap(m_landmarkTable);
+    // the heuristic of a running A* search may not change under it
+    if (hadLandmarks)
+        reset();
+}
+
+std::vector<std::pair<int, int>> PathFinder::getLandmarks() {
+    std::vector<std::pair<int, int>> landmarks;
+    for (int index : m_landmarks)
+        landmarks.push_back(cellPoint(index));
+    return landmarks;
+}
+
+void PathFinder::floodLandmark(int landmark, uint16_t* plane, std::vector<int>& wave, std::vector<int>& nextWave) const {
+    switch (m_neighbourhood) {
+    case Neighbourhood::EIGHT:
+        floodLandmark<EightNeighbours>(landmark, plane, wave, nextWave);
+        break;
+    case Neighbourhood::EIGHT_NO_CORNER_CUTTING:
+        floodLandmark<EightNeighboursNoCornerCutting>(landmark, plane, wave, nextWave);
+        break;
+    case Neighbourhood::HEX:
+        floodLandmark<HexNeighbours>(landmark, plane, wave, nextWave);
+        break;
+    default:
+    case Neighbourhood::FOUR:
+        floodLandmark<FourNeighbours>(landmark, plane, wave, nextWave);
+        break;
+    }
+}
+
+template<class Neighbours>
+void PathFinder::floodLandmark(int landmark, uint16_t* plane, std::vector<int>& wave, std::vector<int>& nextWave) const {
+    const MapCell* map = m_map;
+    const int stride = m_stride;
+    std::fill(plane, plane + m_mapSize, LANDMARK_UNREACHABLE);
+
+    plane[landmark] = 0;
+    wave.assign(1, landmark);
+    for (int step = 1; !wave.empty(); step++) {
+        const uint16_t steps = (uint16_t)std::min(step, LANDMARK_UNREACHABLE - 1);
+        nextWave.clear();
+        for (int current : wave) {
+            visitDirections<Neighbours>([&](auto direction) {
+                constexpr int d = decltype(direction)::value;
+                int next = current + Neighbours::DY[d] * stride + Neighbours::DX[d];
+                if (map[next] == MapCell::WALL || plane[next] != LANDMARK_UNREACHABLE || !passesCorner<Neighbours, d>(map, current, stride))
+                    return false;
+
+                plane[next] = steps;
+                nextWave.push_back(next);
+                return false;
+            });
+        }
+        wave.swap(nextWave);
+    }
+}
+
+void PathFinder::floodLandmarks() {
+    const int count = (int)m_landmarks.size();
+    m_landmarkTable.assign(m_mapSize * count, LANDMARK_UNREACHABLE);
+
+    if (!m_threadPool)
+        m_threadPool = std::make_unique<ThreadPool>(m_threadCount);
+    const int workers = std::min(count, m_threadPool->getThreadCount());
+    std::vector<std::vector<uint16_t>> planes(workers, std::vector<uint16_t>(m_mapSize));
+    std::vector<std::vector<int>> waves(workers), nextWaves(workers);
+
+    for (int first = 0; first < count; first += workers) {
+        const int round = std::min(workers, count - first);
+        m_threadPool->run([&](int worker) {
+            floodLandmark(m_landmarks[first + worker], planes[worker].data(), waves[worker], nextWaves[worker]);
+        }, round);
+
+        // every worker copies a range of cells, so no two of them write the same part of the table
+        m_threadPool->run([&](int worker) {
+            size_t begin = m_mapSize * worker / workers, end = m_mapSize * (worker + 1) / workers;
+            for (size_t index = begin; index < end; index++) {
+                uint16_t* row = &m_landmarkTable[index * count + first];
+                for (int landmark = 0; landmark < round; landmark++)
+                    row[landmark] = planes[landmark][index];
+            }
+        }, workers);
+    }
+}
+
+int PathFinder::landmarkBound(int from, int to) const {
+    const size_t count = m_landmarks.size();
+    const uint16_t* fromSteps = &m_landmarkTable[from * count];
+    const uint16_t* toSteps = &m_landmarkTable[to * count];
+
+    int bound = 0;
+    for (size_t landmark = 0; landmark < count; landmark++) {
+        if (fromSteps[landmark] == LANDMARK_UNREACHABLE || toSteps[landmark] == LANDMARK_UNREACHABLE)
+            continue;
+        bound = std::max(bound, std::abs(fromSteps[landmark] - toSteps[landmark]));
+    }
+    return bound;
+}
+
+bool PathFinder::estimateDistance(int x1, int y1, int x2, int y2, int& lower, int& upper) {
+    lower = upper = -1;
+    if (m_landmarks.empty() || x1 < 0 || y1 < 0 || x1 >= m_mapWidth || y1 >= m_mapHeight
+        || x2 < 0 || y2 < 0 || x2 >= m_mapWidth || y2 >= m_mapHeight)
+        return false;
+
+    const size_t count = m_landmarks.size();
+    const uint16_t* fromSteps = &m_landmarkTable[cellIndex(x1, y1) * count];
+    const uint16_t* toSteps = &m_landmarkTable[cellIndex(x2, y2) * count];
+
+    bool reached = false;
+    for (size_t landmark = 0; landmark < count; landmark++) {
+        int from = fromSteps[landmark], to = toSteps[landmark];
+        if (from == LANDMARK_UNREACHABLE || to == LANDMARK_UNREACHABLE)
+            continue;
+
+        reached = true;
+        lower = std::max(lower, std::abs(from - to));
+        // a saturated distance says nothing about the way through the landmark
+        if (from < LANDMARK_UNREACHABLE - 1 && to < LANDMARK_UNREACHABLE - 1 && (upper == -1 || from + to < upper))
+            upper = from + to;
+    }
+    if (!reached)
+        lower = -1;
+    return reached;
+}
\ No newline at end of file
@@ -0,0 +1,137 @@
+#include "PathFinder.h"
+#include "PathFinderNeighbourhood.h"
+
+/*
+neighbourhood policies for the wave and the path trace
+a policy lists its directions as constexpr offsets. expandWave() and traceWave() visit them with
+a fold expression over the direction indices, so every direction becomes straight-line code with
+its offset, and the corner check only exists for the diagonals that need it - there is no loop
+and no branch over directions left at run time. The padded border covers the diagonals as well.
+the wave matrix is read and written through DenseWave or PagedWave, so both storages get their own
+instantiation and the dense one stays a plain array access.
+*/
+
+long long PathFinder::processWaveStep(long long maxCells) {
+    if (m_waveStorage == WaveStorage::PAGED)
+        return expandNeighbourhood(PagedWave{ this }, maxCells);
+    return expandNeighbourhood(DenseWave{ m_waveMatrix.data(), this }, maxCells);
+}
+
+template<class Wave>
+long long PathFinder::expandNeighbourhood(Wave wave, long long maxCells) {
+    switch (m_neighbourhood) {
+    case Neighbourhood::EIGHT:
+        return expandWave<EightNeighbours>(wave, maxCells);
+    case Neighbourhood::EIGHT_NO_CORNER_CUTTING:
+        return expandWave<EightNeighboursNoCornerCutting>(wave, maxCells);
+    case Neighbourhood::HEX:
+        return expandWave<HexNeighbours>(wave, maxCells);
+    default:
+    case Neighbourhood::FOUR:
+        return expandWave<FourNeighbours>(wave, maxCells);
+    }
+}
+
+template<class Neighbours, class Wave>
+long long PathFinder::expandWave(Wave wave, long long maxCells) {
+    const MapCell* map = m_map;
+    const int stride = m_stride;
+    const int endIndex = targetIndex();
+
+    int nextStep = m_waveStep + 1;
+    // a level stopped by a budget goes on from m_waveCursor with the part of the next level in m_wave
+    if (m_waveCursor == 0)
+        m_wave.clear();
+
+    size_t first = m_waveCursor;
+    size_t last = m_oldWave.size();
+    if ((long long)(last - first) > maxCells)
+        last = first + (size_t)maxCells;
+
+    bool reached = false;
+    size_t i = first;
+    while (i < last && !reached) {
+        int current = m_oldWave[i++];
+        reached = visitDirections<Neighbours>([&](auto direction) {
+            constexpr int d = decltype(direction)::value;
+            int next = current + Neighbours::DY[d] * stride + Neighbours::DX[d];
+            if (map[next] == MapCell::WALL || wave.get(next) != -1 || !passesCorner<Neighbours, d>(map, current, stride))
+                return false;
+
+            wave.set(next, nextStep);
+            m_wave.push_back(next);
+            return next == endIndex;
+        });
+    }
+
+    if (reached)
+        m_reachedPoint = true;
+    else if (i < m_oldWave.size()) {
+        m_waveCursor = i;
+        return (long long)(i - first);
+    }
+
+    m_waveCursor = 0;
+    m_waveStep = nextStep;
+    m_oldWave.swap(m_wave);
+    return (long long)(i - first);
+}
+
+// walks down the step numbers of waveMatrix from cell "from" to cell "to", appending every visited cell.
+// with costs the previous cell is the neighbour whose step plus the cost of the current cell gives its step
+void PathFinder::tracePath(const std::vector<int>& waveMatrix, int from, int to, std::vector<std::pair<int, int>>& path, const uint8_t* costs) {
+    // the trace only reads, the cast never leads to a write
+    traceNeighbourhood(DenseWave{ const_cast<int*>(waveMatrix.data()), this }, from, to, path, costs);
+}
+
+void PathFinder::tracePath(int from, int to, std::vector<std::pair<int, int>>& path, const uint8_t* costs) {
+    if (m_waveStorage == WaveStorage::PAGED)
+        traceNeighbourhood(PagedWave{ this }, from, to, path, costs);
+    else
+        tracePath(m_waveMatrix, from, to, path, costs);
+}
+
+template<class Wave>
+void PathFinder::traceNeighbourhood(Wave wave, int from, int to, std::vector<std::pair<int, int>>& path, const uint8_t* costs) {
+    switch (m_neighbourhood) {
+    case Neighbourhood::EIGHT:
+        traceWave<EightNeighbours>(wave, from, to, path, costs);
+        break;
+    case Neighbourhood::EIGHT_NO_CORNER_CUTTING:
+        traceWave<EightNeighboursNoCornerCutting>(wave, from, to, path, costs);
+        break;
+    case Neighbourhood::HEX:
+        traceWave<HexNeighbours>(wave, from, to, path, costs);
+        break;
+    default:
+    case Neighbourhood::FOUR:
+        traceWave<FourNeighbours>(wave, from, to, path, costs);
+        break;
+    }
+}
+
+template<class Neighbours, class Wave>
+void PathFinder::traceWave(Wave wave, int from, int to, std::vector<std::pair<int, int>>& path, const uint8_t* costs) {
+    const int stride = m_stride;
+
+    int current = from;
+    path.push_back(cellPoint(current));
+
+    while (current != to) {
+        int previousStep = wave.get(current) - (costs ? costs[current] : 1);
+        // every policy is symmetric, a step back passes the same corner as the step forward
+        bool found = visitDirections<Neighbours>([&](auto direction) {
+            constexpr int d = decltype(direction)::value;
+            int next = current + Neighbours::DY[d] * stride + Neighbours::DX[d];
+            if (wave.get(next) != previousStep || !passesCorner<Neighbours, d>(m_map, current, stride))
+                return false;
+
+            current = next;
+            return true;
+        });
+
+        if (!found)
+            break;
+        path.push_back(cellPoint(current));
+    }
+}
\ No newline at end of file
@@ -0,0 +1,64 @@
+#ifndef __PATH_FINDER_NEIGHBOURHOOD_H__
+#define __PATH_FINDER_NEIGHBOURHOOD_H__
+#include "PathFinder.h"
+#include <utility>
+#include <type_traits>
+
+// neighbourhood policies shared by the wave, the path trace and the flow field, not part of the public interface
+
+struct FourNeighbours {
+	static constexpr int COUNT = 4;
+	static constexpr int DX[COUNT] = { 0, 1, 0, -1 };
+	static constexpr int DY[COUNT] = { -1, 0, 1, 0 };
+	static constexpr bool CUTS_CORNERS = true;
+};
+
+struct EightNeighbours {
+	static constexpr int COUNT = 8;
+	static constexpr int DX[COUNT] = { 0, 1, 0, -1, 1, 1, -1, -1 };
+	static constexpr int DY[COUNT] = { -1, 0, 1, 0, -1, 1, 1, -1 };
+	static constexpr bool CUTS_CORNERS = true;
+};
+
+struct EightNeighboursNoCornerCutting : EightNeighbours {
+	static constexpr bool CUTS_CORNERS = false;
+};
+
+struct HexNeighbours {
+	static constexpr int COUNT = 6;
+	static constexpr int DX[COUNT] = { 0, 1, 1, 0, -1, -1 };
+	static constexpr int DY[COUNT] = { -1, -1, 0, 1, 1, 0 };
+	static constexpr bool CUTS_CORNERS = true;
+};
+
+// calls visit(direction) for every direction until one returns true
+template<class Neighbours, class Visit, int... Directions>
+static inline bool visitDirections(Visit&& visit, std::integer_sequence<int, Directions...>) {
+	return (visit(std::integral_constant<int, Directions>()) || ...);
+}
+
+template<class Neighbours, class Visit>
+static inline bool visitDirections(Visit&& visit) {
+	return visitDirections<Neighbours>(visit, std::make_integer_sequence<int, Neighbours::COUNT>());
+}
+
+// diagonals that may not cut corners need both cells beside the step free, everything else passes
+template<class Neighbours, int Direction>
+static inline bool passesCorner(const PathFinder::MapCell* map, int from, int stride) {
+	constexpr int dx = Neighbours::DX[Direction], dy = Neighbours::DY[Direction];
+	if constexpr (!Neighbours::CUTS_CORNERS && dx != 0 && dy != 0)
+		return map[from + dx] != PathFinder::MapCell::WALL && map[from + dy * stride] != PathFinder::MapCell::WALL;
+	return true;
+}
+
+// index of the direction that undoes Direction, every policy lists both
+template<class Neighbours, int Direction>
+static constexpr int oppositeDirection() {
+	for (int d = 0; d < Neighbours::COUNT; d++) {
+		if (Neighbours::DX[d] == -Neighbours::DX[Direction] && Neighbours::DY[d] == -Neighbours::DY[Direction])
+			return d;
+	}
+	return -1;
+}
+
+#endif //!__PATH_FINDER_NEIGHBOURHOOD_H__
\ No newline at end of file
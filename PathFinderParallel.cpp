@@ -0,0 +1,125 @@
+#include "PathFinder.h"
+#include "ThreadPool.h"
+#include <atomic>
+#include <algorithm>
+#include <climits>
+
+/*
+level-synchronous parallel wave
+every processStep() splits one wave level across the worker pool:
+- top-down: each worker expands its slice of m_oldWave and claims unvisited neighbours
+  with a compare-and-swap on m_waveMatrix, so every cell is taken by exactly one worker.
+- bottom-up: once the frontier is large compared to the unvisited area, workers instead sweep
+  their own band of rows and label every unvisited cell that has a neighbour on the current level.
+both produce the same step numbers as processWaveStep(). The level in which END is reached is
+always finished, so the path is the same while a few more cells of that level may be labelled.
+*/
+
+// frontier cells (or swept cells) a worker should get before it is worth waking another thread
+static const int PARALLEL_GRAIN = 4096;
+// switch to bottom-up sweeps when frontier * ratio exceeds the unvisited cells
+static const int BOTTOM_UP_RATIO = 14;
+
+void PathFinder::setThreadCount(int threadCount) {
+    m_threadCount = threadCount;
+    m_threadPool.reset();
+    if (m_searchMode == SearchMode::PARALLEL)
+        reset();
+}
+
+void PathFinder::resetParallel() {
+    if (!m_threadPool)
+        m_threadPool = std::make_unique<ThreadPool>(m_threadCount);
+    m_localWaves.resize(m_threadPool->getThreadCount());
+
+    m_unvisitedCells = 0;
+    for (size_t i = 0; i < m_mapSize; i++)
+        m_unvisitedCells += m_map[i] != MapCell::WALL;
+    m_unvisitedCells = std::max(0LL, m_unvisitedCells - 1);
+}
+
+void PathFinder::processParallelStep() {
+    const int offsets[4] = { -m_stride, 1, m_stride, -1 };
+    const MapCell* map = m_map;
+    int* waveMatrix = m_waveMatrix.data();
+    const int endIndex = targetIndex();
+    const int currentStep = m_waveStep;
+    const int nextStep = m_waveStep + 1;
+    const int threads = m_threadPool->getThreadCount();
+
+    std::atomic<bool> reached(false);
+    int workers;
+
+    if ((long long)m_oldWave.size() * BOTTOM_UP_RATIO > m_unvisitedCells) {
+        int minRow = INT_MAX, maxRow = -1;
+        for (int index : m_oldWave) {
+            int row = index / m_stride;
+            minRow = std::min(minRow, row);
+            maxRow = std::max(maxRow, row);
+        }
+        const int firstRow = std::max(1, minRow - 1);
+        const int rows = std::min(m_mapHeight, maxRow + 1) - firstRow + 1;
+        workers = std::clamp((int)((long long)rows * m_stride / PARALLEL_GRAIN), 1, threads);
+
+        auto sweepRows = [&](int worker) {
+            std::vector<int>& local = m_localWaves[worker];
+            local.clear();
+            int rowEnd = firstRow + (int)((long long)rows * (worker + 1) / workers);
+            for (int y = firstRow + (int)((long long)rows * worker / workers); y < rowEnd; y++) {
+                for (int index = y * m_stride + 1; index <= y * m_stride + m_mapWidth; index++) {
+                    if (map[index] == MapCell::WALL || std::atomic_ref<int>(waveMatrix[index]).load(std::memory_order_relaxed) != -1)
+                        continue;
+
+                    for (int d = 0; d < 4; d++) {
+                        if (std::atomic_ref<int>(waveMatrix[index + offsets[d]]).load(std::memory_order_relaxed) != currentStep)
+                            continue;
+
+                        std::atomic_ref<int>(waveMatrix[index]).store(nextStep, std::memory_order_relaxed);
+                        local.push_back(index);
+                        if (index == endIndex)
+                            reached.store(true, std::memory_order_relaxed);
+                        break;
+                    }
+                }
+            }
+        };
+        // std::ref keeps std::function from copying the closure to the heap every step
+        m_threadPool->run(std::ref(sweepRows), workers);
+    }
+    else {
+        const int frontier = (int)m_oldWave.size();
+        workers = std::clamp(frontier / PARALLEL_GRAIN, 1, threads);
+
+        auto expandFrontier = [&](int worker) {
+            std::vector<int>& local = m_localWaves[worker];
+            local.clear();
+            int end = (int)((long long)frontier * (worker + 1) / workers);
+            for (int i = (int)((long long)frontier * worker / workers); i < end; i++) {
+                int current = m_oldWave[i];
+                for (int d = 0; d < 4; d++) {
+                    int next = current + offsets[d];
+                    if (map[next] == MapCell::WALL)
+                        continue;
+
+                    int unvisited = -1;
+                    if (!std::atomic_ref<int>(waveMatrix[next]).compare_exchange_strong(unvisited, nextStep, std::memory_order_relaxed))
+                        continue;
+
+                    local.push_back(next);
+                    if (next == endIndex)
+                        reached.store(true, std::memory_order_relaxed);
+                }
+            }
+        };
+        m_threadPool->run(std::ref(expandFrontier), workers);
+    }
+
+    m_wave.clear();
+    for (int worker = 0; worker < workers; worker++)
+        m_wave.insert(m_wave.end(), m_localWaves[worker].begin(), m_localWaves[worker].end());
+    m_unvisitedCells -= (long long)m_wave.size();
+
+    m_reachedPoint = reached.load();
+    m_waveStep = nextStep;
+    m_oldWave.swap(m_wave);
+}
\ No newline at end of file
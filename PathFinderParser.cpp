@@ -0,0 +1,154 @@
+#include "PathFinder.h"
+#include "MappedFile.h"
+
+/*
+string map data parser
+write maps in format:
+0,0,0,0,0,0
+0,0,1,0,0,0
+0,0,0,1,0,0
+0,0,0,0,1,0
+0,0,0,0,0,0
+
+EMPTY = 0
+WALL = 1
+START = 2
+END = 3
+
+empty lines, spaces, tabs and '\r' are ignored, a ',' at the end of a row is allowed.
+the text is read once and the cells go straight into the padded grid, nothing is
+allocated per cell or per row.
+*/
+
+void PathFinder::setMap(std::string map) {
+    setMap(map.data(), map.size());
+}
+
+bool PathFinder::loadMap(const std::string& fileName) {
+    MappedFile file;
+    if (!file.open(fileName)) {
+        m_lastError = "can't open " + fileName;
+        log("loadMap: " + m_lastError);
+        return false;
+    }
+    return setMap(file.getData(), file.getSize());
+}
+
+bool PathFinder::setMap(const char* data, size_t size) {
+    const char* p = data;
+    const char* const end = data + size;
+
+    std::vector<MapCell> grid;
+    // the first row goes to a side buffer until the width, and with it the stride, is known
+    std::vector<MapCell> firstRow;
+    int width = -1, stride = 0, height = 0;
+    int startX = 0, startY = 0, endX = 0, endY = 0;
+
+    int line = 1;
+    int column = 0;             // cells in the current row
+    bool afterComma = false;    // a cell has to follow
+    size_t rowBase = 0;         // grid index of the current row's first inner cell
+
+    auto fail = [&](const std::string& message) {
+        m_lastError = "line " + std::to_string(line) + ": " + message;
+        log("setMap: " + m_lastError);
+        return false;
+    };
+
+    auto finishRow = [&]() {
+        if (column == 0) {
+            if (afterComma)
+                return fail("row starts with ','");
+            return true;
+        }
+
+        if (width == -1) {
+            width = column;
+            stride = width + 2;
+            // one cell takes at least two characters, enough room for all rows in most files
+            grid.reserve((size / (2 * (size_t)width) + 3) * stride);
+            // top border, first row and the bottom border, every later row takes the place of the
+            // bottom border and appends a new one
+            grid.assign((size_t)stride * 3, MapCell::WALL);
+            std::copy(firstRow.begin(), firstRow.end(), grid.begin() + stride + 1);
+            for (int x = 0; x < width; x++) {
+                if (firstRow[x] == MapCell::START) { startX = x; startY = 0; }
+                else if (firstRow[x] == MapCell::END) { endX = x; endY = 0; }
+            }
+        }
+        else if (column != width) {
+            return fail("row has " + std::to_string(column) + " cells, expected " + std::to_string(width));
+        }
+
+        height++;
+        column = 0;
+        afterComma = false;
+        return true;
+    };
+
+    while (p < end) {
+        char c = *p++;
+
+        if (c >= '0' && c <= '9') {
+            if (column > 0 && !afterComma)
+                return fail("missing ',' between cells");
+
+            int value = c - '0';
+            while (p < end && *p >= '0' && *p <= '9' && value <= 3)
+                value = value * 10 + (*p++ - '0');
+            if (value > 3)
+                return fail("unknown cell value in column " + std::to_string(column + 1));
+
+            MapCell cell = (MapCell)value;
+            if (width == -1) {
+                firstRow.push_back(cell);
+            }
+            else {
+                if (column == 0) {
+                    rowBase = grid.size() - stride + 1;
+                    grid.resize(grid.size() + stride, MapCell::WALL);
+                }
+                if (column >= width)
+                    return fail("row has more than " + std::to_string(width) + " cells");
+                grid[rowBase + column] = cell;
+
+                if (cell == MapCell::START) { startX = column; startY = height; }
+                else if (cell == MapCell::END) { endX = column; endY = height; }
+            }
+
+            column++;
+            afterComma = false;
+        }
+        else if (c == ',') {
+            if (column == 0 || afterComma)
+                return fail("empty cell in column " + std::to_string(column + 1));
+            afterComma = true;
+        }
+        else if (c == '\n') {
+            if (!finishRow())
+                return false;
+            line++;
+        }
+        else if (c != ' ' && c != '\t' && c != '\r') {
+            return fail(std::string("unexpected character '") + c + "'");
+        }
+    }
+
+    if (!finishRow())
+        return false;
+    if (width == -1)
+        return fail("map has no cells");
+
+    m_mapStorage.swap(grid);
+    useMapStorage();
+    m_mapWidth = width;
+    m_mapHeight = height;
+    m_stride = stride;
+    m_startX = startX;
+    m_startY = startY;
+    m_endX = endX;
+    m_endY = endY;
+    m_lastError.clear();
+    reset();
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,72 @@
+#include "PathFinder.h"
+#include "SharedMap.h"
+
+/*
+shared maps
+m_map points straight into the grid of a SharedMap, nothing is copied. The search engines only
+read m_map and the costs, the few places that write - cell edits, costs and the START and END
+markers - detach first or leave the shared grid alone, so finders on one SharedMap never race.
+*/
+
+void PathFinder::setMap(std::shared_ptr<const SharedMap> map) {
+    if (!map || map->getWidth() < 1 || map->getHeight() < 1)
+        return;
+
+    useMapStorage();
+    std::vector<MapCell>().swap(m_mapStorage);
+    m_sharedMap = std::move(map);
+    // never written while m_sharedMap is set
+    m_map = const_cast<MapCell*>(m_sharedMap->getGrid());
+    m_mapSize = m_sharedMap->getGridSize();
+    m_mapWidth = m_sharedMap->getWidth();
+    m_mapHeight = m_sharedMap->getHeight();
+    m_stride = m_sharedMap->getStride();
+    m_startX = m_sharedMap->getStartX();
+    m_startY = m_sharedMap->getStartY();
+    m_endX = m_sharedMap->getEndX();
+    m_endY = m_sharedMap->getEndY();
+    reset();
+}
+
+std::shared_ptr<const SharedMap> PathFinder::shareMap() {
+    if (m_sharedMap)
+        return m_sharedMap;
+    if (m_mapSize == 0)
+        return nullptr;
+
+    std::vector<MapCell> grid(m_map, m_map + m_mapSize);
+    return std::make_shared<const SharedMap>(m_mapWidth, m_mapHeight, std::move(grid), m_costs,
+        m_startX, m_startY, m_endX, m_endY);
+}
+
+const uint8_t* PathFinder::costData() const {
+    if (m_sharedMap)
+        return m_sharedMap->getCosts();
+    return m_costs.empty() ? nullptr : m_costs.data();
+}
+
+void PathFinder::detachSharedMap() {
+    if (!m_sharedMap)
+        return;
+
+    m_mapStorage.assign(m_map, m_map + m_mapSize);
+    const uint8_t* costs = m_sharedMap->getCosts();
+    if (costs)
+        m_costs.assign(costs, costs + m_mapSize);
+    else
+        m_costs.clear();
+    m_map = m_mapStorage.data();
+
+    // the private copy gets its markers where the points are
+    int sharedStart = cellIndex(m_sharedMap->getStartX(), m_sharedMap->getStartY());
+    int sharedEnd = cellIndex(m_sharedMap->getEndX(), m_sharedMap->getEndY());
+    m_sharedMap.reset();
+    for (int index : { sharedStart, sharedEnd }) {
+        if (m_map[index] == MapCell::START || m_map[index] == MapCell::END)
+            m_map[index] = MapCell::EMPTY;
+    }
+    if (m_map[cellIndex(m_startX, m_startY)] == MapCell::EMPTY)
+        m_map[cellIndex(m_startX, m_startY)] = MapCell::START;
+    if (m_map[cellIndex(m_endX, m_endY)] == MapCell::EMPTY)
+        m_map[cellIndex(m_endX, m_endY)] = MapCell::END;
+}
\ No newline at end of file
@@ -0,0 +1,93 @@
+#include "PathFinder.h"
+#include <algorithm>
+#include <cstdio>
+
+/*
+search statistics and trace export
+compile with PATH_FINDER_STATS to collect them. The hooks sit around whole processStep() calls,
+the slices of processFor() and reset(), the wave loops themselves are never touched, and without
+the define the hooks are not compiled at all.
+
+a Chrome trace has one complete event for reset() and one per step, with the frontier and
+the labelled cells as arguments and as counter tracks.
+*/
+
+void PathFinder::resetStats() {
+    m_stats.resetTime = 0;
+    m_stats.searchTime = 0;
+    m_stats.cellsExpanded = 0;
+    m_stats.steps = 0;
+    m_stats.maxFrontier = 0;
+    m_stats.pathLength = -1;
+    m_stats.stepStats.clear();
+    m_statsOrigin = std::chrono::steady_clock::now();
+}
+
+double PathFinder::statsTime(std::chrono::steady_clock::time_point time) const {
+    return std::chrono::duration<double, std::micro>(time - m_statsOrigin).count();
+}
+
+void PathFinder::recordReset() {
+    m_stats.resetTime = statsTime(std::chrono::steady_clock::now());
+}
+
+void PathFinder::recordStep(std::chrono::steady_clock::time_point start, int frontier, int labelled) {
+    StepStats step;
+    step.step = m_stats.steps;
+    step.frontier = frontier;
+    step.start = statsTime(start);
+    step.duration = statsTime(std::chrono::steady_clock::now()) - step.start;
+    step.labelled = labelled;
+
+    m_stats.steps++;
+    m_stats.searchTime += step.duration;
+    m_stats.cellsExpanded += step.labelled;
+    m_stats.maxFrontier = std::max(m_stats.maxFrontier, frontier);
+    m_stats.stepStats.push_back(step);
+
+    if (m_stepCallback)
+        m_stepCallback(step);
+}
+
+void PathFinder::recordPath(size_t length) {
+    m_stats.pathLength = (int)length;
+}
+
+std::string PathFinder::getTraceJson() {
+    std::string json = "{\"traceEvents\":[\n";
+    char event[256];
+
+    snprintf(event, sizeof(event),
+        "{\"name\":\"reset\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":0,\"dur\":%.3f,\"args\":{\"cells\":%zu}}",
+        m_stats.resetTime, m_mapSize);
+    json += event;
+
+    for (const StepStats& step : m_stats.stepStats) {
+        snprintf(event, sizeof(event),
+            ",\n{\"name\":\"processStep\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f,"
+            "\"args\":{\"step\":%d,\"frontier\":%d,\"labelled\":%d}}",
+            step.start, step.duration, step.step, step.frontier, step.labelled);
+        json += event;
+        snprintf(event, sizeof(event),
+            ",\n{\"name\":\"wave\",\"ph\":\"C\",\"pid\":1,\"ts\":%.3f,\"args\":{\"frontier\":%d,\"labelled\":%d}}",
+            step.start, step.frontier, step.labelled);
+        json += event;
+    }
+
+    snprintf(event, sizeof(event),
+        "\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"cellsExpanded\":%lld,\"steps\":%d,\"pathLength\":%d}}\n",
+        m_stats.cellsExpanded, m_stats.steps, m_stats.pathLength);
+    json += event;
+    return json;
+}
+
+bool PathFinder::saveTrace(const std::string& fileName) {
+    FILE* file = fopen(fileName.c_str(), "w");
+    if (!file) {
+        log("saveTrace: can't write " + fileName);
+        return false;
+    }
+    std::string json = getTraceJson();
+    bool written = fwrite(json.data(), 1, json.size(), file) == json.size();
+    return fclose(file) == 0 && written;
+}
\ No newline at end of file
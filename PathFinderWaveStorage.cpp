@@ -0,0 +1,114 @@
+#include "PathFinder.h"
+#include <algorithm>
+
+/*
+wave storage
+filling the whole wave matrix with -1 before every search costs as much as a flood, however short
+the query. The matrix is therefore split into pages of WAVE_PAGE_CELLS cells and every engine that
+labels a cell notes its page once, so reset() refills only the pages of the last search. The bitboard
+and parallel engines and the incremental repair don't note pages, after them the whole matrix is filled
+as before. The A* and JPS buffers and the backward matrix of the bidirectional search are cleared on
+the same pages.
+
+PAGED storage goes one step further for maps too large to hold a matrix per finder: the page table
+points to nothing until the wave labels a cell of a page, an unlabelled page reads -1. Pages are
+recycled through a free list, so a warmed up finder doesn't allocate.
+*/
+
+void PathFinder::setWaveStorage(WaveStorage storage) {
+    if (storage == m_waveStorage)
+        return;
+
+    m_waveStorage = storage;
+    m_touchedPages.clear();
+    if (storage == WaveStorage::PAGED) {
+        std::vector<int>().swap(m_waveMatrix);
+        std::vector<int>().swap(m_backWaveMatrix);
+        std::vector<uint8_t>().swap(m_pageTouched);
+        std::vector<uint8_t>().swap(m_closed);
+        std::vector<int>().swap(m_jumpParent);
+        std::vector<int8_t>().swap(m_jumpDirection);
+    }
+    else {
+        std::vector<int*>().swap(m_wavePages);
+        std::vector<int*>().swap(m_freeWavePages);
+        m_wavePagePool.clear();
+    }
+    m_pagesTracked = false;
+    reset();
+}
+
+size_t PathFinder::getWaveMemoryUsage() {
+    if (m_waveStorage == WaveStorage::PAGED)
+        return m_wavePagePool.size() * WAVE_PAGE_CELLS * sizeof(int) + m_wavePages.capacity() * sizeof(int*);
+    return m_waveMatrix.capacity() * sizeof(int) + m_pageTouched.capacity();
+}
+
+int* PathFinder::allocateWavePage(int page) {
+    int* cells;
+    if (!m_freeWavePages.empty()) {
+        cells = m_freeWavePages.back();
+        m_freeWavePages.pop_back();
+    }
+    else {
+        m_wavePagePool.push_back(std::make_unique<int[]>(WAVE_PAGE_CELLS));
+        cells = m_wavePagePool.back().get();
+    }
+    std::fill(cells, cells + WAVE_PAGE_CELLS, -1);
+    m_touchedPages.push_back(page);
+    return cells;
+}
+
+void PathFinder::clearSearchCells() {
+    const size_t pageCount = (m_mapSize + WAVE_PAGE_CELLS - 1) >> WAVE_PAGE_SHIFT;
+
+    if (m_waveStorage == WaveStorage::PAGED) {
+        for (int page : m_touchedPages) {
+            m_freeWavePages.push_back(m_wavePages[page]);
+            m_wavePages[page] = nullptr;
+        }
+        m_touchedPages.clear();
+        m_wavePages.resize(pageCount, nullptr);
+        return;
+    }
+
+    // a new map size or an engine that didn't note its pages, everything is filled
+    if (!m_pagesTracked || m_waveMatrix.size() != m_mapSize || m_pageTouched.size() != pageCount) {
+        m_waveMatrix.assign(m_mapSize, -1);
+        if (!m_backWaveMatrix.empty())
+            m_backWaveMatrix.assign(m_mapSize, -1);
+        if (!m_closed.empty())
+            m_closed.assign(m_mapSize, 0);
+        if (!m_jumpParent.empty()) {
+            m_jumpParent.assign(m_mapSize, -1);
+            m_jumpDirection.assign(m_mapSize, -1);
+        }
+        m_pageTouched.assign(pageCount, 0);
+        m_touchedPages.clear();
+        return;
+    }
+
+    for (int page : m_touchedPages) {
+        size_t first = (size_t)page << WAVE_PAGE_SHIFT;
+        size_t last = std::min(first + WAVE_PAGE_CELLS, m_mapSize);
+        std::fill(m_waveMatrix.begin() + first, m_waveMatrix.begin() + last, -1);
+        if (!m_backWaveMatrix.empty())
+            std::fill(m_backWaveMatrix.begin() + first, m_backWaveMatrix.begin() + last, -1);
+        if (!m_closed.empty())
+            std::fill(m_closed.begin() + first, m_closed.begin() + last, 0);
+        if (!m_jumpParent.empty()) {
+            std::fill(m_jumpParent.begin() + first, m_jumpParent.begin() + last, -1);
+            std::fill(m_jumpDirection.begin() + first, m_jumpDirection.begin() + last, -1);
+        }
+        m_pageTouched[page] = 0;
+    }
+    m_touchedPages.clear();
+}
+
+int PathFinder::waveStep(int index) const {
+    if (m_waveStorage == WaveStorage::PAGED) {
+        const int* page = (size_t)index < m_mapSize ? m_wavePages[index >> WAVE_PAGE_SHIFT] : nullptr;
+        return page ? page[index & (WAVE_PAGE_CELLS - 1)] : -1;
+    }
+    return m_waveMatrix.empty() ? -1 : m_waveMatrix[index];
+}
\ No newline at end of file
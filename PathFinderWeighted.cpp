@@ -0,0 +1,67 @@
+#include "PathFinder.h"
+#include <algorithm>
+
+/*
+per-cell costs
+entering a cell costs 1 to MAX_CELL_COST, so roads, mud or stairs can be modelled. The costs
+are kept in the padded layout next to the map. The weighted search runs on the bucket queue of
+PathFinderHeuristic.cpp: costs are small integers, so the open distances span at most
+MAX_CELL_COST + 1 buckets and every cell is pushed and popped in O(1) - no binary heap.
+a map whose costs are all 1 drops them and keeps the plain wave.
+*/
+
+static uint8_t clampCost(int cost) {
+    return (uint8_t)std::clamp(cost, 1, PathFinder::MAX_CELL_COST);
+}
+
+bool PathFinder::setCosts(const std::vector<uint8_t>& costs, int cols) {
+    if (cols != m_mapWidth || costs.size() != (size_t)m_mapWidth * m_mapHeight) {
+        log("setCosts: costs don't match the map size");
+        return false;
+    }
+    detachSharedMap();
+
+    m_costs.assign(m_mapSize, 1);
+    bool unitCost = true;
+    for (int y = 0; y < m_mapHeight; y++) {
+        for (int x = 0; x < m_mapWidth; x++) {
+            uint8_t cost = clampCost(costs[(size_t)y * cols + x]);
+            m_costs[cellIndex(x, y)] = cost;
+            unitCost = unitCost && cost == 1;
+        }
+    }
+    if (unitCost)
+        m_costs.clear();
+    m_flowGoal = -1;
+    reset();
+    return true;
+}
+
+void PathFinder::setCellCost(int x, int y, int cost) {
+    if (x < 0 || y < 0 || x >= m_mapWidth || y >= m_mapHeight)
+        return;
+
+    detachSharedMap();
+    if (m_costs.empty()) {
+        if (clampCost(cost) == 1)
+            return;
+        m_costs.assign(m_mapSize, 1);
+    }
+    m_costs[cellIndex(x, y)] = clampCost(cost);
+    m_flowGoal = -1;
+    reset();
+}
+
+int PathFinder::getCellCost(int x, int y) {
+    if (x < 0 || y < 0 || x >= m_mapWidth || y >= m_mapHeight)
+        return -1;
+    const uint8_t* costs = costData();
+    return costs ? costs[cellIndex(x, y)] : 1;
+}
+
+void PathFinder::clearCosts() {
+    detachSharedMap();
+    m_costs.clear();
+    m_flowGoal = -1;
+    reset();
+}
\ No newline at end of file
@@ -0,0 +1,111 @@
+#include "SharedMap.h"
+
+SharedMap::SharedMap(int width, int height, std::vector<PathFinder::MapCell> grid, std::vector<uint8_t> costs,
+    int startX, int startY, int endX, int endY) {
+    m_width = width;
+    m_height = height;
+    m_grid = std::move(grid);
+    m_costs = std::move(costs);
+    m_startX = startX;
+    m_startY = startY;
+    m_endX = endX;
+    m_endY = endY;
+}
+
+std::shared_ptr<const SharedMap> SharedMap::create(const PathFinder::Map& map) {
+    PathFinder loader;
+    loader.setMap(map);
+    return loader.shareMap();
+}
+
+SearchContextPool::SearchContextPool(std::shared_ptr<const SharedMap> map) {
+    m_map = std::move(map);
+    m_searchMode = PathFinder::SearchMode::WAVE;
+    m_neighbourhood = PathFinder::Neighbourhood::FOUR;
+    m_contextCount = 0;
+}
+
+SearchContextPool::Lease SearchContextPool::acquire() {
+    std::unique_ptr<PathFinder> context;
+    PathFinder::SearchMode mode;
+    PathFinder::Neighbourhood neighbourhood;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_idle.empty()) {
+            context = std::move(m_idle.back());
+            m_idle.pop_back();
+        }
+        else
+            m_contextCount++;
+        mode = m_searchMode;
+        neighbourhood = m_neighbourhood;
+    }
+
+    // everything below only touches the context, the lock isn't needed
+    if (!context) {
+        context = std::make_unique<PathFinder>();
+        context->setMap(m_map);
+    }
+    // settings are only applied when they differ, each one resets the search
+    if (context->getSearchMode() != mode)
+        context->setSearchMode(mode);
+    if (context->getNeighbourhood() != neighbourhood)
+        context->setNeighbourhood(neighbourhood);
+    return Lease(this, std::move(context));
+}
+
+void SearchContextPool::release(std::unique_ptr<PathFinder> context) {
+    // the context is still private here, it's cleaned before another thread can take it
+    context->cancel();
+    context->setStepCallback(nullptr);
+    context->setWaveStorage(PathFinder::WaveStorage::DENSE);
+    // setMap() drops the private copy and everything built on it, the buffers stay
+    if (context->getSharedMap() != m_map || context->hasFlowField() || context->hasComponents() || context->hasLandmarks())
+        context->setMap(m_map);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_idle.push_back(std::move(context));
+}
+
+void SearchContextPool::setSearchMode(PathFinder::SearchMode mode) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_searchMode = mode;
+}
+
+void SearchContextPool::setNeighbourhood(PathFinder::Neighbourhood neighbourhood) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_neighbourhood = neighbourhood;
+}
+
+int SearchContextPool::getContextCount() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_contextCount;
+}
+
+SearchContextPool::Lease::Lease(SearchContextPool* pool, std::unique_ptr<PathFinder> context) {
+    m_pool = pool;
+    m_context = std::move(context);
+}
+
+SearchContextPool::Lease::Lease(Lease&& other) noexcept {
+    m_pool = other.m_pool;
+    m_context = std::move(other.m_context);
+}
+
+SearchContextPool::Lease& SearchContextPool::Lease::operator=(Lease&& other) noexcept {
+    if (this != &other) {
+        release();
+        m_pool = other.m_pool;
+        m_context = std::move(other.m_context);
+    }
+    return *this;
+}
+
+SearchContextPool::Lease::~Lease() {
+    release();
+}
+
+void SearchContextPool::Lease::release() {
+    if (m_context)
+        m_pool->release(std::move(m_context));
+}
\ No newline at end of file
@@ -0,0 +1,104 @@
+#ifndef __SHARED_MAP_H__
+#define __SHARED_MAP_H__
+#include "PathFinder.h"
+#include <vector>
+#include <memory>
+#include <mutex>
+
+/*
+read-only map shared by many searches
+a SharedMap holds the padded grid and the costs of a PathFinder and never changes, so any number
+of threads can search it at once without locks. A PathFinder given a SharedMap keeps only its
+search state, so memory grows with the searches running at the same time, not with threads x map size.
+
+std::shared_ptr<const SharedMap> map = SharedMap::create(grid);
+SearchContextPool pool(map);
+// on any thread
+SearchContextPool::Lease search = pool.acquire();
+search->setEndpoints(startX, startY, endX, endY);
+search->process(path);
+*/
+class SharedMap {
+public:
+	// grid and costs are padded as in PathFinder: cell (x, y) is at (y + 1) * (width + 2) + (x + 1)
+	// and the border is WALL. Costs are empty for a unit-cost map
+	SharedMap(int width, int height, std::vector<PathFinder::MapCell> grid, std::vector<uint8_t> costs,
+		int startX, int startY, int endX, int endY);
+
+	static std::shared_ptr<const SharedMap> create(const PathFinder::Map& map);
+
+	int getWidth() const { return m_width; }
+	int getHeight() const { return m_height; }
+	int getStride() const { return m_width + 2; }
+	const PathFinder::MapCell* getGrid() const { return m_grid.data(); }
+	size_t getGridSize() const { return m_grid.size(); }
+	// nullptr for a unit-cost map
+	const uint8_t* getCosts() const { return m_costs.empty() ? nullptr : m_costs.data(); }
+
+	int getStartX() const { return m_startX; }
+	int getStartY() const { return m_startY; }
+	int getEndX() const { return m_endX; }
+	int getEndY() const { return m_endY; }
+private:
+	int m_width, m_height;
+	std::vector<PathFinder::MapCell> m_grid;
+	std::vector<uint8_t> m_costs;
+	int m_startX, m_startY, m_endX, m_endY;
+};
+
+/*
+recycles search contexts for one shared map.
+acquire() hands out an idle PathFinder bound to the map, or creates one if all of them are busy.
+a context goes back to the pool with its buffers when its lease ends, so the next query on any
+thread reuses them and the pool only ever holds as many contexts as queries ran at the same time.
+whatever a lease left behind besides the search - a private map copy from edits or costs, a flow field,
+components, landmarks, PAGED storage or a step callback - is dropped on the way back, so every lease
+starts on the shared map as it is.
+*/
+class SearchContextPool {
+public:
+	explicit SearchContextPool(std::shared_ptr<const SharedMap> map);
+
+	SearchContextPool(const SearchContextPool&) = delete;
+	SearchContextPool& operator=(const SearchContextPool&) = delete;
+
+	// the context of one query, returned to the pool when the lease is destroyed
+	class Lease {
+	public:
+		Lease(SearchContextPool* pool, std::unique_ptr<PathFinder> context);
+		Lease(Lease&& other) noexcept;
+		Lease& operator=(Lease&& other) noexcept;
+		~Lease();
+
+		PathFinder& operator*() { return *m_context; }
+		PathFinder* operator->() { return m_context.get(); }
+	private:
+		void release();
+
+		SearchContextPool* m_pool;
+		std::unique_ptr<PathFinder> m_context;
+	};
+
+	// thread-safe, a context comes with the search mode and neighbourhood set on the pool
+	Lease acquire();
+
+	// applies to contexts acquired afterwards
+	void setSearchMode(PathFinder::SearchMode mode);
+	void setNeighbourhood(PathFinder::Neighbourhood neighbourhood);
+
+	const std::shared_ptr<const SharedMap>& getMap() const { return m_map; }
+	// contexts created so far, the most queries that ran at the same time
+	int getContextCount();
+private:
+	void release(std::unique_ptr<PathFinder> context);
+
+	std::shared_ptr<const SharedMap> m_map;
+	PathFinder::SearchMode m_searchMode;
+	PathFinder::Neighbourhood m_neighbourhood;
+
+	std::mutex m_mutex;
+	std::vector<std::unique_ptr<PathFinder>> m_idle;
+	int m_contextCount;
+};
+
+#endif //!__SHARED_MAP_H__
\ No newline at end of file
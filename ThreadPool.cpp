@@ -0,0 +1,137 @@
+#include "ThreadPool.h"
+#include <algorithm>
+#include <memory>
+
+ThreadPool::ThreadPool(int threadCount) {
+    if (threadCount < 1)
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+    m_threadCount = threadCount;
+    m_job = nullptr;
+    m_activeWorkers = 0;
+    m_pendingWorkers = 0;
+    m_generation = 0;
+    m_stop = false;
+
+    for (int i = 1; i < threadCount; i++)
+        m_threads.emplace_back(&ThreadPool::workerLoop, this, i);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for (std::thread& thread : m_threads)
+        thread.join();
+}
+
+void ThreadPool::run(const std::function<void(int)>& job, int workers) {
+    workers = std::clamp(workers, 1, m_threadCount);
+    if (workers == 1) {
+        job(0);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_job = &job;
+        m_activeWorkers = workers;
+        m_pendingWorkers = workers - 1;
+        m_generation++;
+    }
+    m_wake.notify_all();
+
+    job(0);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this] { return m_pendingWorkers == 0; });
+    m_job = nullptr;
+}
+
+namespace {
+    // remaining task indices [begin, end) of one worker
+    struct TaskRange {
+        std::mutex mutex;
+        int begin = 0;
+        int end = 0;
+    };
+}
+
+void ThreadPool::runTasks(int count, const std::function<void(int, int)>& task) {
+    if (count <= 0)
+        return;
+
+    const int workers = std::min(m_threadCount, count);
+    std::unique_ptr<TaskRange[]> ranges(new TaskRange[workers]);
+    for (int i = 0; i < workers; i++) {
+        ranges[i].begin = (int)((long long)count * i / workers);
+        ranges[i].end = (int)((long long)count * (i + 1) / workers);
+    }
+
+    run([&](int worker) {
+        TaskRange& own = ranges[worker];
+        while (true) {
+            int taskIndex = -1;
+            {
+                std::lock_guard<std::mutex> lock(own.mutex);
+                if (own.begin < own.end)
+                    taskIndex = own.begin++;
+            }
+
+            if (taskIndex != -1) {
+                task(worker, taskIndex);
+                continue;
+            }
+
+            // own range is empty, take the back half of somebody else's
+            bool stolen = false;
+            for (int i = 1; i < workers && !stolen; i++) {
+                TaskRange& victim = ranges[(worker + i) % workers];
+                int stolenBegin, stolenEnd;
+                {
+                    std::lock_guard<std::mutex> lock(victim.mutex);
+                    int remaining = victim.end - victim.begin;
+                    if (remaining <= 0)
+                        continue;
+                    stolenEnd = victim.end;
+                    stolenBegin = victim.end - (remaining + 1) / 2;
+                    victim.end = stolenBegin;
+                }
+
+                std::lock_guard<std::mutex> lock(own.mutex);
+                own.begin = stolenBegin;
+                own.end = stolenEnd;
+                stolen = true;
+            }
+
+            if (!stolen)
+                return;
+        }
+    }, workers);
+}
+
+void ThreadPool::workerLoop(int workerIndex) {
+    uint64_t seenGeneration = 0;
+    while (true) {
+        const std::function<void(int)>* job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [&] { return m_stop || m_generation != seenGeneration; });
+            if (m_stop)
+                return;
+
+            seenGeneration = m_generation;
+            if (workerIndex >= m_activeWorkers)
+                continue;
+            job = m_job;
+        }
+
+        (*job)(workerIndex);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (--m_pendingWorkers == 0)
+            m_done.notify_one();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,49 @@
+#ifndef __THREAD_POOL_H__
+#define __THREAD_POOL_H__
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <cstdint>
+
+/*
+fixed set of worker threads for fork-join jobs.
+run(job, workers) calls job(workerIndex) once for every worker index in [0, workers)
+and returns when all of them have finished. The calling thread works as worker 0.
+runTasks(count, task) spreads task indices over the workers, a worker that runs out of
+tasks steals half of the remaining range of another one.
+*/
+class ThreadPool {
+public:
+	// threadCount < 1 uses all hardware threads
+	explicit ThreadPool(int threadCount = 0);
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	int getThreadCount() const { return m_threadCount; }
+
+	void run(const std::function<void(int)>& job, int workers);
+	void run(const std::function<void(int)>& job) { run(job, m_threadCount); }
+
+	// calls task(workerIndex, taskIndex) for every taskIndex in [0, count)
+	void runTasks(int count, const std::function<void(int, int)>& task);
+private:
+	void workerLoop(int workerIndex);
+
+	int m_threadCount;
+	std::vector<std::thread> m_threads;
+
+	std::mutex m_mutex;
+	std::condition_variable m_wake;
+	std::condition_variable m_done;
+	const std::function<void(int)>* m_job;
+	int m_activeWorkers;
+	int m_pendingWorkers;
+	uint64_t m_generation;
+	bool m_stop;
+};
+
+#endif //!__THREAD_POOL_H__
\ No newline at end of file
@@ -0,0 +1,488 @@
+#include "PathFinder.h"
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+/*
+benchmark of the PathFinder on generated maps
+every map is generated from the seed alone, so the same arguments give the same maps on every
+machine. For each map kind, size and search mode it measures setMap(), whole queries with
+process(), single processStep() calls and calculatePath(), and prints a table or writes JSON.
+on POSIX systems every case runs in a child process of its own, so its peak memory is not the
+peak of the largest case before it. On Windows all cases share the process and the column is the
+process high-water mark.
+
+benchmark [--sizes 64,256,1024,4096] [--maps maze,open,empty,rooms,random] [--modes wave,astar,weighted,paged,...]
+          [--queries 50] [--seed 1] [--json results.json]
+
+sizes up to 16384 work, a 16384 x 16384 map needs 1.5 to 3 GB depending on the mode.
+*/
+
+typedef PathFinder::MapCell Cell;
+typedef std::chrono::steady_clock Clock;
+
+static double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// generators only use raw mt19937 output, the standard distributions differ between libraries
+static int randomBelow(std::mt19937& rng, int n) {
+    return (int)(rng() % (uint32_t)n);
+}
+
+// perfect maze: passages on odd cells carved by a depth-first backtracker, walls elsewhere
+static std::vector<Cell> generateMaze(int size, std::mt19937& rng) {
+    std::vector<Cell> map((size_t)size * size, Cell::WALL);
+    const int cells = (size - 1) / 2;
+    if (cells < 1)
+        return map;
+
+    const int dx[4] = { 0, 1, 0, -1 };
+    const int dy[4] = { -1, 0, 1, 0 };
+    std::vector<int> stack = { 0 };
+    map[(size_t)1 * size + 1] = Cell::EMPTY;
+
+    while (!stack.empty()) {
+        int cx = stack.back() % cells, cy = stack.back() / cells;
+        int options[4], count = 0;
+        for (int d = 0; d < 4; d++) {
+            int nx = cx + dx[d], ny = cy + dy[d];
+            if (nx >= 0 && ny >= 0 && nx < cells && ny < cells && map[(size_t)(ny * 2 + 1) * size + nx * 2 + 1] == Cell::WALL)
+                options[count++] = d;
+        }
+        if (count == 0) {
+            stack.pop_back();
+            continue;
+        }
+
+        int d = options[randomBelow(rng, count)];
+        map[(size_t)(cy * 2 + 1 + dy[d]) * size + cx * 2 + 1 + dx[d]] = Cell::EMPTY;
+        map[(size_t)((cy + dy[d]) * 2 + 1) * size + (cx + dx[d]) * 2 + 1] = Cell::EMPTY;
+        stack.push_back((cy + dy[d]) * cells + cx + dx[d]);
+    }
+    return map;
+}
+
+static std::vector<Cell> generateObstacles(int size, int wallPercent, std::mt19937& rng) {
+    std::vector<Cell> map((size_t)size * size);
+    for (Cell& cell : map)
+        cell = randomBelow(rng, 100) < wallPercent ? Cell::WALL : Cell::EMPTY;
+    return map;
+}
+
+// square rooms of 24 cells separated by one cell walls, every room has a door to the right and one below
+static std::vector<Cell> generateRooms(int size, std::mt19937& rng) {
+    const int room = 24;
+    std::vector<Cell> map((size_t)size * size, Cell::EMPTY);
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            if (x % room == room - 1 || y % room == room - 1)
+                map[(size_t)y * size + x] = Cell::WALL;
+        }
+    }
+
+    for (int ry = 0; ry * room < size; ry++) {
+        for (int rx = 0; rx * room < size; rx++) {
+            int right = rx * room + room - 1, bottom = ry * room + room - 1;
+            int doorY = std::min(size - 1, ry * room + randomBelow(rng, room - 1));
+            int doorX = std::min(size - 1, rx * room + randomBelow(rng, room - 1));
+            if (right < size)
+                map[(size_t)doorY * size + right] = Cell::EMPTY;
+            if (bottom < size)
+                map[(size_t)bottom * size + doorX] = Cell::EMPTY;
+        }
+    }
+    return map;
+}
+
+static std::vector<Cell> generateMap(const std::string& kind, int size, uint32_t seed) {
+    std::mt19937 rng(seed * 7919u + (uint32_t)size);
+    if (kind == "maze")
+        return generateMaze(size, rng);
+    if (kind == "open")
+        return generateObstacles(size, 2, rng);
+    if (kind == "empty")
+        return std::vector<Cell>((size_t)size * size, Cell::EMPTY);
+    if (kind == "rooms")
+        return generateRooms(size, rng);
+    return generateObstacles(size, 30, rng);
+}
+
+// entering a cell costs 1 to 5, for the weighted mode
+static std::vector<uint8_t> generateCosts(int size, uint32_t seed) {
+    std::mt19937 rng(seed * 104729u + (uint32_t)size);
+    std::vector<uint8_t> costs((size_t)size * size);
+    for (uint8_t& cost : costs)
+        cost = (uint8_t)(1 + randomBelow(rng, 5));
+    return costs;
+}
+
+// what the peak memory column measures, see measureCase()
+#if defined(_WIN32)
+static const char* PEAK_MEMORY_SCOPE = "process";
+#else
+static const char* PEAK_MEMORY_SCOPE = "case";
+#endif
+
+static size_t peakMemoryBytes() {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return counters.PeakWorkingSetSize;
+    return 0;
+#else
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+    return (size_t)usage.ru_maxrss;
+#else
+    return (size_t)usage.ru_maxrss * 1024;
+#endif
+#endif
+}
+
+struct Percentiles {
+    double p50, p90, p99, max;
+};
+
+// microseconds
+static Percentiles percentiles(std::vector<double> samples) {
+    Percentiles result = {};
+    if (samples.empty())
+        return result;
+
+    std::sort(samples.begin(), samples.end());
+    auto at = [&](double q) { return samples[std::min(samples.size() - 1, (size_t)(q * samples.size()))] * 1e6; };
+    result.p50 = at(0.5);
+    result.p90 = at(0.9);
+    result.p99 = at(0.99);
+    result.max = samples.back() * 1e6;
+    return result;
+}
+
+struct Mode {
+    const char* name;
+    PathFinder::SearchMode mode;
+    PathFinder::WaveStorage storage;
+    bool costs;
+};
+
+static const Mode MODES[] = {
+    { "wave", PathFinder::SearchMode::WAVE, PathFinder::WaveStorage::DENSE, false },
+    { "bitboard", PathFinder::SearchMode::BITBOARD, PathFinder::WaveStorage::DENSE, false },
+    { "bidirectional", PathFinder::SearchMode::BIDIRECTIONAL, PathFinder::WaveStorage::DENSE, false },
+    { "parallel", PathFinder::SearchMode::PARALLEL, PathFinder::WaveStorage::DENSE, false },
+    { "astar", PathFinder::SearchMode::ASTAR, PathFinder::WaveStorage::DENSE, false },
+    { "jps", PathFinder::SearchMode::JPS, PathFinder::WaveStorage::DENSE, false },
+    // Dial's algorithm over costs of 1 to 5, without costs it would run the plain wave
+    { "weighted", PathFinder::SearchMode::WEIGHTED, PathFinder::WaveStorage::DENSE, true },
+    // the wave with its matrix allocated page by page
+    { "paged", PathFinder::SearchMode::WAVE, PathFinder::WaveStorage::PAGED, false },
+};
+
+// the numbers of one case, plain data so that a child process can send them through a pipe
+struct Measurement {
+    double setMapMs;
+    int queries;
+    int found;
+    Percentiles process;
+    Percentiles step;
+    Percentiles path;
+    double cellsPerSecond;
+    size_t peakMemory;
+};
+
+struct Result : Measurement {
+    std::string map;
+    int size;
+    std::string mode;
+};
+
+static std::vector<std::string> split(const std::string& list) {
+    std::vector<std::string> parts;
+    size_t begin = 0;
+    while (begin <= list.size()) {
+        size_t end = list.find(',', begin);
+        if (end == std::string::npos)
+            end = list.size();
+        if (end > begin)
+            parts.push_back(list.substr(begin, end - begin));
+        begin = end + 1;
+    }
+    return parts;
+}
+
+// counts the cells the last search labelled wherever its engine keeps them, so cells/s compares across
+// modes: the bidirectional search adds its backward wave, a PAGED wave is only read on its allocated pages,
+// the bitboard engine keeps its cells in the visited bits and fills the matrix in only for the views
+class BenchmarkFinder : public PathFinder {
+public:
+    long long labelledCells() const {
+        long long count = 0;
+        if (m_waveStorage == WaveStorage::PAGED) {
+            for (int page : m_touchedPages)
+                count += WAVE_PAGE_CELLS - std::count(m_wavePages[page], m_wavePages[page] + WAVE_PAGE_CELLS, -1);
+            return count;
+        }
+
+        if (m_searchMode == SearchMode::BITBOARD && !m_visitedBits.empty()) {
+            for (int tile : m_visitedTiles)
+                count += std::popcount(m_visitedBits[tile]);
+            return count;
+        }
+
+        count = (long long)m_waveMatrix.size() - std::count(m_waveMatrix.begin(), m_waveMatrix.end(), -1);
+        if (m_searchMode == SearchMode::BIDIRECTIONAL && m_backWaveMatrix.size() == m_waveMatrix.size())
+            count += (long long)m_backWaveMatrix.size() - std::count(m_backWaveMatrix.begin(), m_backWaveMatrix.end(), -1);
+        return count;
+    }
+};
+
+static Measurement runCase(int size, const Mode& mode, const std::vector<Cell>& map, int queries, uint32_t seed) {
+    Measurement result = {};
+    result.queries = queries;
+
+    BenchmarkFinder finder;
+    finder.setSearchMode(mode.mode);
+    finder.setWaveStorage(mode.storage);
+    Clock::time_point start = Clock::now();
+    finder.setMap(map, size);
+    result.setMapMs = secondsSince(start) * 1e3;
+    if (mode.costs)
+        finder.setCosts(generateCosts(size, seed), size);
+
+    if (std::find(map.begin(), map.end(), Cell::EMPTY) == map.end())
+        return result;
+
+    // the same endpoints for every mode, free cells are drawn by rejection so large maps need no index of them
+    std::mt19937 rng(seed);
+    auto randomFreeCell = [&]() {
+        int index;
+        do {
+            index = randomBelow(rng, (int)map.size());
+        } while (map[index] == Cell::WALL);
+        return index;
+    };
+    std::vector<double> processTimes, pathTimes;
+    std::vector<std::pair<int, int>> path;
+    long long expanded = 0;
+    double searchSeconds = 0;
+    int reachableQuery = -1;
+    std::vector<int> endpoints;
+
+    for (int q = 0; q < queries; q++) {
+        int from = randomFreeCell();
+        int to = randomFreeCell();
+        endpoints.push_back(from);
+        endpoints.push_back(to);
+        finder.setEndpoints(from % size, from / size, to % size, to / size);
+
+        start = Clock::now();
+        finder.process(path);
+        double seconds = secondsSince(start);
+        processTimes.push_back(seconds);
+        searchSeconds += seconds;
+        expanded += finder.labelledCells();
+
+        if (!path.empty()) {
+            result.found++;
+            if (reachableQuery == -1)
+                reachableQuery = q;
+        }
+
+        start = Clock::now();
+        finder.calculatePath(path);
+        pathTimes.push_back(secondsSince(start));
+    }
+
+    // single steps of the first query that has a path
+    std::vector<double> stepTimes;
+    if (reachableQuery != -1) {
+        int from = endpoints[reachableQuery * 2], to = endpoints[reachableQuery * 2 + 1];
+        finder.setEndpoints(from % size, from / size, to % size, to / size);
+        while (!finder.isPointReached()) {
+            start = Clock::now();
+            finder.processStep();
+            stepTimes.push_back(secondsSince(start));
+        }
+    }
+
+    result.process = percentiles(processTimes);
+    result.path = percentiles(pathTimes);
+    result.step = percentiles(stepTimes);
+    result.cellsPerSecond = searchSeconds > 0 ? expanded / searchSeconds : 0;
+    result.peakMemory = peakMemoryBytes();
+    return result;
+}
+
+// runs the case in a child process and takes the peak memory of that child alone
+static Measurement measureCase(int size, const Mode& mode, const std::vector<Cell>& map, int queries, uint32_t seed) {
+#if defined(_WIN32)
+    return runCase(size, mode, map, queries, seed);
+#else
+    int channel[2];
+    if (pipe(channel) != 0)
+        return runCase(size, mode, map, queries, seed);
+    pid_t child = fork();
+    if (child < 0) {
+        close(channel[0]);
+        close(channel[1]);
+        return runCase(size, mode, map, queries, seed);
+    }
+    if (child == 0) {
+        close(channel[0]);
+        Measurement measurement = runCase(size, mode, map, queries, seed);
+        const char* data = (const char*)&measurement;
+        for (size_t written = 0; written < sizeof(measurement);) {
+            ssize_t count = write(channel[1], data + written, sizeof(measurement) - written);
+            if (count <= 0)
+                _exit(1);
+            written += (size_t)count;
+        }
+        _exit(0);
+    }
+
+    close(channel[1]);
+    Measurement measurement = {};
+    char* data = (char*)&measurement;
+    size_t received = 0;
+    while (received < sizeof(measurement)) {
+        ssize_t count = read(channel[0], data + received, sizeof(measurement) - received);
+        if (count <= 0)
+            break;
+        received += (size_t)count;
+    }
+    close(channel[0]);
+
+    int status = 0;
+    struct rusage usage;
+    if (wait4(child, &status, 0, &usage) == child && received == sizeof(measurement)) {
+#if defined(__APPLE__)
+        measurement.peakMemory = (size_t)usage.ru_maxrss;
+#else
+        measurement.peakMemory = (size_t)usage.ru_maxrss * 1024;
+#endif
+    }
+    else {
+        fprintf(stderr, "case %s %d failed in its child process\n", mode.name, size);
+        measurement = {};
+    }
+    return measurement;
+#endif
+}
+
+static void writeJson(FILE* file, const std::vector<Result>& results, uint32_t seed) {
+    auto writePercentiles = [file](const char* name, const Percentiles& p) {
+        fprintf(file, "\"%s\": {\"p50\": %.3f, \"p90\": %.3f, \"p99\": %.3f, \"max\": %.3f}", name, p.p50, p.p90, p.p99, p.max);
+    };
+
+    fprintf(file, "{\n  \"seed\": %u,\n  \"unit\": \"microseconds\",\n  \"peakMemoryScope\": \"%s\",\n  \"results\": [\n",
+        seed, PEAK_MEMORY_SCOPE);
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result& r = results[i];
+        fprintf(file, "    {\"map\": \"%s\", \"size\": %d, \"mode\": \"%s\", \"setMapMs\": %.3f, \"queries\": %d, \"found\": %d, ",
+            r.map.c_str(), r.size, r.mode.c_str(), r.setMapMs, r.queries, r.found);
+        writePercentiles("process", r.process);
+        fprintf(file, ", ");
+        writePercentiles("processStep", r.step);
+        fprintf(file, ", ");
+        writePercentiles("calculatePath", r.path);
+        fprintf(file, ", \"cellsPerSecond\": %.0f, \"peakMemoryBytes\": %zu}%s\n",
+            r.cellsPerSecond, r.peakMemory, i + 1 < results.size() ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::string> sizes = { "64", "256", "1024", "4096" };
+    std::vector<std::string> maps = { "maze", "open", "empty", "rooms", "random" };
+    std::vector<std::string> modes = { "wave", "bitboard", "bidirectional", "parallel", "astar", "jps", "weighted", "paged" };
+    int queries = 50;
+    uint32_t seed = 1;
+    std::string jsonFile;
+
+    for (int i = 1; i < argc; i++) {
+        std::string argument = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (argument == "--sizes" && hasValue)
+            sizes = split(argv[++i]);
+        else if (argument == "--maps" && hasValue)
+            maps = split(argv[++i]);
+        else if (argument == "--modes" && hasValue)
+            modes = split(argv[++i]);
+        else if (argument == "--queries" && hasValue)
+            queries = std::max(1, atoi(argv[++i]));
+        else if (argument == "--seed" && hasValue)
+            seed = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        else if (argument == "--json" && hasValue)
+            jsonFile = argv[++i];
+        else {
+            printf("usage: benchmark [--sizes 64,256,1024,4096] [--maps maze,open,empty,rooms,random]\n"
+                "                 [--modes wave,bitboard,bidirectional,parallel,astar,jps,weighted,paged]\n"
+                "                 [--queries 50] [--seed 1] [--json results.json]\n");
+            return 1;
+        }
+    }
+
+    std::vector<Result> results;
+    printf("%-7s %6s %-13s %9s %11s %11s %11s %11s %12s %9s\n",
+        "map", "size", "mode", "setMap ms", "process p50", "process p99", "step p99", "path p50", "cells/s", PEAK_MEMORY_SCOPE[0] == 'c' ? "peak MB" : "HWM MB");
+
+    for (const std::string& sizeText : sizes) {
+        int size = atoi(sizeText.c_str());
+        if (size < 2)
+            continue;
+
+        for (const std::string& kind : maps) {
+            std::vector<Cell> map = generateMap(kind, size, seed);
+            for (const std::string& modeName : modes) {
+                const Mode* mode = nullptr;
+                for (const Mode& candidate : MODES) {
+                    if (modeName == candidate.name)
+                        mode = &candidate;
+                }
+                if (!mode) {
+                    printf("unknown mode %s\n", modeName.c_str());
+                    return 1;
+                }
+
+                Result r;
+                static_cast<Measurement&>(r) = measureCase(size, *mode, map, queries, seed);
+                r.map = kind;
+                r.size = size;
+                r.mode = mode->name;
+                printf("%-7s %6d %-13s %9.2f %9.0fus %9.0fus %9.0fus %9.1fus %12.3g %9.1f\n",
+                    r.map.c_str(), r.size, r.mode.c_str(), r.setMapMs, r.process.p50, r.process.p99,
+                    r.step.p99, r.path.p50, r.cellsPerSecond, r.peakMemory / (1024.0 * 1024.0));
+                fflush(stdout);
+                results.push_back(r);
+            }
+        }
+    }
+
+    if (!jsonFile.empty()) {
+        FILE* file = fopen(jsonFile.c_str(), "w");
+        if (!file) {
+            printf("can't write %s\n", jsonFile.c_str());
+            return 1;
+        }
+        writeJson(file, results, seed);
+        fclose(file);
+    }
+    return 0;
+}
\ No newline at end of file
@@ -1,100 +1,8 @@
 #include <SFML/Graphics.hpp>
 #include "PathFinder.h"
+#include "GridRenderer.h"
 using namespace sf;
-typedef PathFinder::MapCell Cell;
 
-void drawMap(sf::RenderWindow& window, PathFinder& algorithm, Vector2f tileSize, Vector2f spacing, Vector2f offSet) {
-    PathFinder::Map map = algorithm.getMap();
-    
-    for (int y = 0; y < map.size(); y++) {
-        for (int x = 0; x < map[y].size(); x++) {
-            Cell cell = map[y][x];
-
-            Vector2f tilePos;
-            tilePos.x = offSet.x + x * tileSize.x + x * spacing.x;
-            tilePos.y = offSet.y + y * tileSize.y + y * spacing.y;
-
-            RectangleShape rectangle = RectangleShape(tileSize);
-            rectangle.setPosition(tilePos);
-            Color fillColor;
-
-            switch (cell)
-            {
-            default:
-            case Cell::EMPTY:
-                fillColor = Color(0, 0, 0, 0);
-                break;
-            case Cell::WALL:
-                fillColor = Color::White;
-                break;
-            case Cell::START:
-                fillColor = Color::Yellow;
-                break;
-            case Cell::END:
-                fillColor = Color::Red;
-                break;
-            }
-
-            rectangle.setFillColor(fillColor);
-            window.draw(rectangle);
-        }
-    }
-}
-void drawWave(sf::RenderWindow& window, const std::vector<std::vector<int>>& waveMatrix, Color color, Vector2f tileSize, Vector2f spacing, Vector2f offSet) {
-    int h = (int)waveMatrix.size();
-    if (h == 0) return;
-    int w = (int)waveMatrix[0].size();
-
-    bool showIndex = false;
-
-    for (int y = 0; y < h; y++) {
-        for (int x = 0; x < w; x++) {
-            int value = waveMatrix[y][x];
-            if (value == -1) continue; // drawing only visited cells
-
-            float percent = value / 10.f;
-            if (percent < 0.f) percent = 0.f;
-            if (percent > 1.f) percent = 1.f;
-
-            sf::Uint8 r = static_cast<sf::Uint8>(color.r * percent);
-            sf::Uint8 g = static_cast<sf::Uint8>(color.g * percent);
-            sf::Uint8 b = static_cast<sf::Uint8>(color.b * percent);
-            sf::Uint8 a = (percent > 0.f) ? color.a * percent : 0.f;
-
-            Color fillColor(r/percent, g/percent, b/percent, a);
-
-            Vector2f tilePos;
-            tilePos.x = offSet.x + x * tileSize.x + x * spacing.x;
-            tilePos.y = offSet.y + y * tileSize.y + y * spacing.y;
-
-            RectangleShape rectangle(tileSize);
-            rectangle.setPosition(tilePos);
-            rectangle.setFillColor(fillColor);
-            window.draw(rectangle);
-
-            if (showIndex) {
-                Font font;
-                font.loadFromFile("arial.ttf");
-                Text text(std::to_string(value), font, 20);
-                text.setPosition(Vector2f(tilePos.x + 5, tilePos.y - 5));
-                text.setFillColor(Color::Red);
-                window.draw(text);
-            }
-        }
-    }
-}
-void drawPath(sf::RenderWindow& window, std::vector<std::pair<int,int>> path, Color color, Vector2f tileSize, Vector2f spacing, Vector2f offSet) {
-    for (int i = 0; i < path.size(); i++) {
-        Vector2f tilePos;
-        tilePos.x = offSet.x + path[i].first * tileSize.x + path[i].first * spacing.x;
-        tilePos.y = offSet.y + path[i].second * tileSize.y + path[i].second * spacing.y;
-
-        RectangleShape rectangle(tileSize);
-        rectangle.setPosition(tilePos);
-        rectangle.setFillColor(color);
-        window.draw(rectangle);
-    }
-}
 int main() {
     sf::RenderWindow window(sf::VideoMode(720, 720), "Wave algorithm");
 
@@ -114,8 +22,13 @@ int main() {
     sf::Clock dtClock;
     sf::Clock tickTimer;
     float tickDelay = 3.5f;
+    bool searching = false;
     
     std::vector<std::pair<int, int>> finalPath = algorithm.getFinalPath();
+
+    GridRenderer renderer(Vector2f(30, 30), Vector2f(2, 2), Vector2f(100, 100));
+    renderer.setWaveGradient(Color(0, 255, 0, 0), Color::Green, 10);
+    renderer.setPathColor(Color::Blue);
     
     while (window.isOpen()) {
         float deltaTime = dtClock.getElapsedTime().asSeconds();
@@ -145,15 +58,23 @@ int main() {
         if (tickTimer.getElapsedTime().asSeconds() >= tickDelay) {
             printf("tick action...\n");
             tickTimer.restart();
-            algorithm.process();
-            finalPath = algorithm.calculatePath();
+            searching = true;
+        }
+
+        // the search runs in slices of a few milliseconds, so a big map never stalls the frame
+        if (searching && algorithm.processFor(std::chrono::milliseconds(2))) {
+            searching = false;
+            algorithm.calculatePath(finalPath);
             printf("%s", algorithm.getMapAsString().c_str());
         }
 
+        // only cells that changed since the last frame are rewritten
+        renderer.updateMap(algorithm.getMapView());
+        //renderer.updateWave(algorithm.getWaveMatrixView());
+        renderer.updatePath(finalPath);
+
         window.clear();
-        drawMap(window, algorithm, Vector2f(30, 30), Vector2f(2, 2), Vector2f(100, 100));
-        //drawWave(window, algorithm.getWaveMatrix(), Color::Green, Vector2f(30, 30), Vector2f(2, 2), Vector2f(100, 100));
-        drawPath(window, finalPath, Color::Blue, Vector2f(30, 30), Vector2f(2, 2), Vector2f(100, 100));
+        window.draw(renderer);
         window.display();
     }
 
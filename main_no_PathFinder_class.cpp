@@ -1,86 +1,22 @@
 #include <SFML/Graphics.hpp>
+#include "GridRenderer.h"
 #include <string>
 #include <vector>
 
 using namespace sf;
 
-void drawMap(sf::RenderWindow& window, std::vector<std::string> map, Vector2f tileSize, Vector2f spacing, Vector2f offSet) {
-    for (int y = 0; y < map.size(); y++) {
-        for (int x = 0; x < map[y].size(); x++) {
-            char symbol = map[y][x];
-
-            Vector2f tilePos;
-            tilePos.x = offSet.x + x * tileSize.x + x * spacing.x;
-            tilePos.y = offSet.y + y * tileSize.y + y * spacing.y;
-
-            RectangleShape rectangle = RectangleShape(tileSize);
-            rectangle.setPosition(tilePos);
-            Color fillColor;
-
-            switch (symbol)
-            {
-            default:
-            case ' ': // free space
-                fillColor = Color(0,0,0,0);
-                break;
-            case '#': // wall
-                fillColor = Color::White;
-                break;
-            case '@': // start point
-                fillColor = Color::Yellow;
-                break;
-            case '*': // end point
-                fillColor = Color::Red;
-                break;
-            }
-
-            rectangle.setFillColor(fillColor);
-            window.draw(rectangle);
-        }
-    }
-}
-
-void drawWave(sf::RenderWindow& window, const std::vector<std::vector<int>>& waveMatrix, Color color, Vector2f tileSize, Vector2f spacing, Vector2f offSet) {
-    int h = (int)waveMatrix.size();
-    if (h == 0) return;
-    int w = (int)waveMatrix[0].size();
-
-    bool showIndex = false;
-
-    for (int y = 0; y < h; y++) {
-        for (int x = 0; x < w; x++) {
-            int value = waveMatrix[y][x];
-            if (value == -1) continue; // drawing only visited cells
-
-            float percent = value / 34.f;
-            if (percent < 0.f) percent = 0.f;
-            if (percent > 1.f) percent = 1.f;
-
-            sf::Uint8 r = static_cast<sf::Uint8>(color.r * percent);
-            sf::Uint8 g = static_cast<sf::Uint8>(color.g * percent);
-            sf::Uint8 b = static_cast<sf::Uint8>(color.b * percent);
-            sf::Uint8 a = color.a;
-
-            Color fillColor(r, g, b, a);
-
-            Vector2f tilePos;
-            tilePos.x = offSet.x + x * tileSize.x + x * spacing.x;
-            tilePos.y = offSet.y + y * tileSize.y + y * spacing.y;
-
-            RectangleShape rectangle(tileSize);
-            rectangle.setPosition(tilePos);
-            rectangle.setFillColor(fillColor);
-            window.draw(rectangle);
-
-            if (showIndex) {
-                Font font;
-                font.loadFromFile("arial.ttf");
-                Text text(std::to_string(value), font, 20);
-                text.setPosition(Vector2f(tilePos.x + 5, tilePos.y - 5));
-                text.setFillColor(Color::Red);
-                window.draw(text);
-            }
-        }
+Color symbolColor(char symbol) {
+    switch (symbol)
+    {
+    default:
+    case ' ': // free space
+        return Color(0, 0, 0, 0);
+    case '#': // wall
+        return Color::White;
+    case '@': // start point
+        return Color::Yellow;
+    case '*': // end point
+        return Color::Red;
     }
 }
 
@@ -185,19 +121,6 @@ std::vector<Vector2i> buildPath(std::vector<std::vector<int>>& waveMatrix, Vecto
     return path;
 }
 
-void drawPath(sf::RenderWindow& window, std::vector<Vector2i> path, Color color, Vector2f tileSize, Vector2f spacing, Vector2f offSet) {
-    for (int i = 0; i < path.size(); i++) {
-        Vector2f tilePos;
-        tilePos.x = offSet.x + path[i].x * tileSize.x + path[i].x * spacing.x;
-        tilePos.y = offSet.y + path[i].y * tileSize.y + path[i].y * spacing.y;
-
-        RectangleShape rectangle(tileSize);
-        rectangle.setPosition(tilePos);
-        rectangle.setFillColor(color);
-        window.draw(rectangle);
-    }
-}
-
 int main() {
     sf::RenderWindow window(sf::VideoMode(1280, 720), "Wave algorithm");
     //window.setFramerateLimit(60);
@@ -249,6 +172,12 @@ int main() {
 
     std::vector<Vector2i> finalPath = {};
 
+    GridRenderer renderer(Vector2f(30, 30), Vector2f(2, 2), Vector2f(100, 100));
+    renderer.resize(matrixWidth, matrixHeight);
+    renderer.setWaveGradient(Color(0, 0, 0, 255), Color::Yellow, 34);
+    renderer.setPathColor(Color::Blue);
+    std::vector<std::pair<int, int>> renderedPath;
+
     while (window.isOpen()) {
         float deltaTime = dtClock.getElapsedTime().asSeconds();
         dtClock.restart();
@@ -315,13 +244,22 @@ int main() {
         snprintf(debugBuffer, 255, "dt: %f; FPS: %d\nWave step: %d; Delay time: %f", deltaTime, (int)(1.f / deltaTime), waveStep, delayTime);
         debugText.setString(std::string(debugBuffer));
         
-        window.clear();
-        drawWave(window, waveMatrix, Color::Yellow, Vector2f(30, 30), Vector2f(2, 2), Vector2f(100, 100));
-        drawMap(window, map, Vector2f(30, 30), Vector2f(2, 2), Vector2f(100, 100));
+        // the renderer only rewrites cells whose colour or step changed
+        for (int y = 0; y < matrixHeight; y++) {
+            for (int x = 0; x < matrixWidth; x++) {
+                renderer.setMapCell(x, y, symbolColor(map[y][x]));
+                renderer.setWaveCell(x, y, waveMatrix[y][x]);
+            }
+        }
+        renderedPath.clear();
         if (pointWasReached) {
-            drawPath(window, finalPath, Color::Blue, Vector2f(30, 30), Vector2f(2, 2), Vector2f(100, 100));
+            for (const Vector2i& point : finalPath)
+                renderedPath.push_back({ point.x, point.y });
         }
+        renderer.updatePath(renderedPath);
 
+        window.clear();
+        window.draw(renderer);
         window.draw(debugText);
         window.display();
     }
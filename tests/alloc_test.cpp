@@ -0,0 +1,145 @@
+#include "../PathFinder.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+/*
+allocation test
+every global operator new is counted. A finder is warmed up on a fixed set of queries, so its buffers,
+bucket entries and wave pages reach their final size, and then runs the same queries again. A steady-state
+query has to get by with what the finder already holds: the measured rounds must not allocate at all,
+for every search mode on DENSE storage and for the wave on PAGED storage, whose pages come back from
+its free list.
+
+g++ -std=c++20 -O2 -pthread tests/alloc_test.cpp PathFinder*.cpp SharedMap.cpp MappedFile.cpp ThreadPool.cpp -o alloc_test
+*/
+
+static std::atomic<long long> allocations{ 0 };
+
+void* operator new(std::size_t size) {
+    allocations++;
+    if (void* memory = std::malloc(size ? size : 1))
+        return memory;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+static const int WIDTH = 300;
+static const int HEIGHT = 200;
+static const int QUERIES = 200;
+
+static int failures = 0;
+
+static std::string randomMap(std::mt19937& random) {
+    std::string map;
+    for (int y = 0; y < HEIGHT; y++) {
+        for (int x = 0; x < WIDTH; x++) {
+            map += random() % 100 < 25 ? '1' : '0';
+            map += x == WIDTH - 1 ? '\n' : ',';
+        }
+    }
+    return map;
+}
+
+static void check(const char* name, long long count) {
+    printf("%-28s %lld allocations\n", name, count);
+    if (count != 0)
+        failures++;
+}
+
+int main() {
+    std::mt19937 random(13);
+    const std::string map = randomMap(random);
+    std::vector<int> points;
+    for (int i = 0; i < QUERIES * 4; i += 2) {
+        points.push_back(random() % WIDTH);
+        points.push_back(random() % HEIGHT);
+    }
+    std::vector<uint8_t> costs(WIDTH * HEIGHT);
+    for (uint8_t& cost : costs)
+        cost = (uint8_t)(1 + random() % 5);
+
+    const std::pair<const char*, PathFinder::SearchMode> modes[] = {
+        { "WAVE", PathFinder::SearchMode::WAVE },
+        { "BITBOARD", PathFinder::SearchMode::BITBOARD },
+        { "BIDIRECTIONAL", PathFinder::SearchMode::BIDIRECTIONAL },
+        { "PARALLEL", PathFinder::SearchMode::PARALLEL },
+        { "ASTAR", PathFinder::SearchMode::ASTAR },
+        { "JPS", PathFinder::SearchMode::JPS },
+        { "WEIGHTED", PathFinder::SearchMode::WEIGHTED },
+    };
+    const std::pair<const char*, PathFinder::WaveStorage> storages[] = {
+        { "DENSE", PathFinder::WaveStorage::DENSE },
+        { "PAGED", PathFinder::WaveStorage::PAGED },
+    };
+
+    std::vector<std::pair<int, int>> path;
+    for (auto [storageName, storage] : storages) {
+        for (auto [modeName, mode] : modes) {
+            PathFinder finder;
+            finder.setMap(map);
+            finder.setWaveStorage(storage);
+            finder.setSearchMode(mode);
+            finder.setThreadCount(2);
+            // WEIGHTED runs its bucket queue only over costs
+            if (mode == PathFinder::SearchMode::WEIGHTED)
+                finder.setCosts(costs, WIDTH);
+
+            // the second round runs exactly the queries of the first one
+            long long before = 0;
+            for (int round = 0; round < 2; round++) {
+                if (round == 1)
+                    before = allocations;
+                for (int i = 0; i < QUERIES * 4; i += 4) {
+                    finder.setEndpoints(points[i], points[i + 1], points[i + 2], points[i + 3]);
+                    finder.process(path);
+                }
+            }
+            long long count = allocations - before;
+            std::string name = std::string(storageName) + " " + modeName;
+            check(name.c_str(), count);
+        }
+    }
+
+    // one flood, then paths to any cell into the same buffer
+    PathFinder flooded;
+    flooded.setMap(map);
+    flooded.setEndpoints(points[0], points[1], points[2], points[3]);
+    flooded.processAll();
+    for (int i = 0; i < QUERIES * 4; i += 2)
+        flooded.calculatePath(points[i], points[i + 1], path);
+    long long before = allocations;
+    for (int i = 0; i < QUERIES * 4; i += 2)
+        flooded.calculatePath(points[i], points[i + 1], path);
+    check("calculatePath after flood", allocations - before);
+
+    if (failures) {
+        printf("FAILED: %d case(s) allocated\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
\ No newline at end of file
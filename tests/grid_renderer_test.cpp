@@ -0,0 +1,185 @@
+#include "../GridRenderer.h"
+#include "../PathFinder.h"
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/*
+headless GridRenderer test
+the vertices are built without a window, so the test reads them back through getMapVertices() and
+friends: every layer has four vertices per cell, every quad shows the colour of its cell after an update,
+a diff update after a processStep() rewrites exactly the quads whose cells changed, and setMapCell()
+and setWaveCell() touch only the quad of their own cell.
+
+g++ -std=c++20 -O2 -pthread tests/grid_renderer_test.cpp GridRenderer.cpp PathFinder*.cpp SharedMap.cpp MappedFile.cpp ThreadPool.cpp -lsfml-graphics -lsfml-window -lsfml-system -o grid_renderer_test
+*/
+
+static const int WIDTH = 7;
+static const int HEIGHT = 5;
+
+static const char* MAP =
+    "0,0,0,0,0,0,0\n"
+    "0,1,1,1,1,1,0\n"
+    "0,0,0,0,0,1,0\n"
+    "1,1,1,1,0,1,0\n"
+    "0,0,0,0,0,0,0\n";
+
+static int failures = 0;
+
+static void check(bool passed, const char* what) {
+    printf("%-60s %s\n", what, passed ? "ok" : "FAILED");
+    if (!passed)
+        failures++;
+}
+
+// the gradient of the test, 200 / 8 keeps every blended channel exact
+static sf::Color waveColor(int step) {
+    if (step == -1)
+        return sf::Color::Transparent;
+    return sf::Color(0, (sf::Uint8)(25 * std::min(step, 8)), 0, 255);
+}
+
+static sf::Color mapColor(PathFinder::MapCell cell) {
+    switch (cell) {
+    case PathFinder::MapCell::WALL:
+        return sf::Color::White;
+    case PathFinder::MapCell::START:
+        return sf::Color::Yellow;
+    case PathFinder::MapCell::END:
+        return sf::Color::Red;
+    default:
+        return sf::Color::Transparent;
+    }
+}
+
+// every corner of a quad carries the colour of the quad
+static bool quadHasColor(const sf::VertexArray& vertices, size_t quad, sf::Color color) {
+    for (size_t corner = 0; corner < 4; corner++) {
+        if (vertices[quad * 4 + corner].color != color)
+            return false;
+    }
+    return true;
+}
+
+static std::vector<sf::Color> colors(const sf::VertexArray& vertices) {
+    std::vector<sf::Color> result;
+    for (size_t i = 0; i < vertices.getVertexCount(); i++)
+        result.push_back(vertices[i].color);
+    return result;
+}
+
+// quads whose colour differs between two snapshots
+static std::vector<size_t> changedQuads(const std::vector<sf::Color>& before, const std::vector<sf::Color>& after) {
+    std::vector<size_t> changed;
+    for (size_t quad = 0; quad * 4 < after.size(); quad++) {
+        for (size_t corner = 0; corner < 4; corner++) {
+            if (before[quad * 4 + corner] != after[quad * 4 + corner]) {
+                changed.push_back(quad);
+                break;
+            }
+        }
+    }
+    return changed;
+}
+
+int main() {
+    PathFinder finder;
+    finder.setMap(std::string(MAP));
+    finder.setEndpoints(0, 0, 0, 4);
+
+    GridRenderer renderer(sf::Vector2f(30, 30), sf::Vector2f(2, 2), sf::Vector2f(100, 100));
+    renderer.setWaveGradient(sf::Color(0, 0, 0, 255), sf::Color(0, 200, 0, 255), 8);
+    renderer.updateMap(finder.getMapView());
+    renderer.updateWave(finder.getWaveMatrixView());
+    renderer.takeRewrittenQuads();
+
+    const size_t vertexCount = (size_t)WIDTH * HEIGHT * 4;
+    check(renderer.getWidth() == WIDTH && renderer.getHeight() == HEIGHT, "updateMap() resizes to the map");
+    check(renderer.getMapVertices().getVertexCount() == vertexCount, "map layer has four vertices per cell");
+    check(renderer.getWaveVertices().getVertexCount() == vertexCount, "wave layer has four vertices per cell");
+
+    const sf::Vertex& corner = renderer.getMapVertices()[(2 * WIDTH + 3) * 4 + 2];
+    check(corner.position.x == 100 + 3 * 32 + 30 && corner.position.y == 100 + 2 * 32 + 30, "quads are placed on the tile grid");
+
+    PathFinder::GridView<PathFinder::MapCell> map = finder.getMapView();
+    bool mapColours = true;
+    for (int y = 0; y < HEIGHT; y++) {
+        for (int x = 0; x < WIDTH; x++)
+            mapColours &= quadHasColor(renderer.getMapVertices(), (size_t)y * WIDTH + x, mapColor(map[y][x]));
+    }
+    check(mapColours, "map quads show their cells");
+
+    renderer.updateMap(finder.getMapView());
+    check(renderer.takeRewrittenQuads() == 0, "an unchanged map rewrites no quad");
+
+    // diff updates step by step, each one rewrites exactly the cells whose step changed
+    // START is labelled before the first step
+    PathFinder::GridView<int> startWave = finder.getWaveMatrixView();
+    std::vector<int> shown;
+    for (int y = 0; y < HEIGHT; y++)
+        shown.insert(shown.end(), startWave[y], startWave[y] + WIDTH);
+    bool stepColours = true, stepQuads = true;
+    for (int step = 0; !finder.isPointReached() && step < WIDTH * HEIGHT; step++) {
+        finder.processStep();
+        std::vector<sf::Color> before = colors(renderer.getWaveVertices());
+        renderer.updateWave(finder.getWaveMatrixView());
+        std::vector<size_t> changed = changedQuads(before, colors(renderer.getWaveVertices()));
+
+        PathFinder::GridView<int> wave = finder.getWaveMatrixView();
+        int changedCells = 0;
+        for (int y = 0; y < HEIGHT; y++) {
+            for (int x = 0; x < WIDTH; x++) {
+                size_t quad = (size_t)y * WIDTH + x;
+                changedCells += shown[quad] != wave[y][x];
+                shown[quad] = wave[y][x];
+                stepColours &= quadHasColor(renderer.getWaveVertices(), quad, waveColor(wave[y][x]));
+            }
+        }
+        stepQuads &= renderer.takeRewrittenQuads() == changedCells && (int)changed.size() == changedCells;
+    }
+    check(finder.isPointReached(), "the search reaches END");
+    check(stepColours, "wave quads show their steps after every step");
+    check(stepQuads, "a step rewrites only the quads of the new wave level");
+
+    // single cells
+    std::vector<sf::Color> before = colors(renderer.getMapVertices());
+    renderer.setMapCell(3, 2, sf::Color::Red);
+    std::vector<size_t> changed = changedQuads(before, colors(renderer.getMapVertices()));
+    check(renderer.takeRewrittenQuads() == 1 && changed.size() == 1 && changed[0] == 2 * WIDTH + 3, "setMapCell() rewrites only its quad");
+    check(quadHasColor(renderer.getMapVertices(), 2 * WIDTH + 3, sf::Color::Red), "setMapCell() colours its quad");
+    renderer.setMapCell(3, 2, sf::Color::Red);
+    check(renderer.takeRewrittenQuads() == 0, "setMapCell() with the shown colour rewrites nothing");
+
+    before = colors(renderer.getWaveVertices());
+    renderer.setWaveCell(6, 0, 3);
+    changed = changedQuads(before, colors(renderer.getWaveVertices()));
+    check(renderer.takeRewrittenQuads() == 1 && changed.size() == 1 && changed[0] == 6, "setWaveCell() rewrites only its quad");
+    check(quadHasColor(renderer.getWaveVertices(), 6, waveColor(3)), "setWaveCell() colours its quad by step");
+    renderer.setWaveCell(6, 0, -1);
+    check(quadHasColor(renderer.getWaveVertices(), 6, sf::Color::Transparent), "setWaveCell() with -1 clears its quad");
+    renderer.takeRewrittenQuads();
+    renderer.setWaveCell(6, 0, -1);
+    check(renderer.takeRewrittenQuads() == 0, "setWaveCell() with the shown step rewrites nothing");
+    renderer.setWaveCell(WIDTH, 0, 1);
+    renderer.setMapCell(-1, 0, sf::Color::Red);
+    check(renderer.takeRewrittenQuads() == 0, "cells outside of the grid are ignored");
+
+    // path layer, four vertices per path cell and rebuilt only when the path changes
+    finder.process();
+    renderer.updatePath(finder.getFinalPathView());
+    bool pathColours = renderer.getPathVertices().getVertexCount() == finder.getFinalPathView().size() * 4;
+    for (size_t quad = 0; pathColours && quad < finder.getFinalPathView().size(); quad++)
+        pathColours &= quadHasColor(renderer.getPathVertices(), quad, sf::Color::Blue);
+    check(!finder.getFinalPathView().empty() && pathColours, "path layer has one quad per path cell");
+    renderer.takeRewrittenQuads();
+    renderer.updatePath(finder.getFinalPathView());
+    check(renderer.takeRewrittenQuads() == 0, "an unchanged path rewrites no quad");
+
+    if (failures) {
+        printf("FAILED: %d check(s)\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
\ No newline at end of file
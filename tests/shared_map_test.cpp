@@ -0,0 +1,106 @@
+#include "../PathFinder.h"
+#include "../SharedMap.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/*
+shared map test
+a SearchContextPool hands its contexts from one lease to the next. Whatever a lease changed besides its
+search must not reach the next one: an edit or costs give the context a private copy of the map, and a
+flow field, components, landmarks or PAGED storage are built on top of it. The test leaves each of them
+behind in a lease and checks that the next lease on the same context searches the shared map as it is.
+
+g++ -std=c++20 -O2 -pthread tests/shared_map_test.cpp PathFinder*.cpp SharedMap.cpp MappedFile.cpp ThreadPool.cpp -o shared_map_test
+*/
+
+static const int WIDTH = 9;
+
+// the short way runs along the top row, the wall at (4, 0) forces the long one round the bottom
+static const char* MAP =
+    "0,0,0,0,0,0,0,0,0\n"
+    "0,1,1,1,1,1,1,1,0\n"
+    "0,1,0,0,0,0,0,1,0\n"
+    "0,1,0,1,1,1,0,1,0\n"
+    "0,0,0,1,0,0,0,0,0\n";
+
+static int failures = 0;
+
+static void check(bool passed, const char* what) {
+    printf("%-60s %s\n", what, passed ? "ok" : "FAILED");
+    if (!passed)
+        failures++;
+}
+
+static size_t pathLength(SearchContextPool::Lease& search) {
+    std::vector<std::pair<int, int>> path;
+    search->setEndpoints(0, 0, WIDTH - 1, 0);
+    search->process(path);
+    return path.size();
+}
+
+int main() {
+    PathFinder loader;
+    loader.setMap(std::string(MAP));
+    std::shared_ptr<const SharedMap> map = loader.shareMap();
+    SearchContextPool pool(map);
+
+    size_t shortest;
+    {
+        SearchContextPool::Lease search = pool.acquire();
+        shortest = pathLength(search);
+    }
+    check(shortest == WIDTH, "a lease finds the shortest path");
+
+    {
+        SearchContextPool::Lease search = pool.acquire();
+        search->setCell(4, 0, PathFinder::MapCell::WALL);
+        check(search->getSharedMap() == nullptr, "an edit gives the lease a private map");
+        check(pathLength(search) > shortest, "the edit changes the path of its lease");
+    }
+    {
+        SearchContextPool::Lease search = pool.acquire();
+        check(search->getSharedMap() == map, "the next lease is back on the shared map");
+        check(pathLength(search) == shortest, "an edit isn't visible to the next lease");
+    }
+
+    // WEIGHTED searches by cost, an expensive cell on the top row sends it round the bottom
+    pool.setSearchMode(PathFinder::SearchMode::WEIGHTED);
+    {
+        SearchContextPool::Lease search = pool.acquire();
+        search->setCellCost(2, 0, 50);
+        check(pathLength(search) > shortest, "costs change the path of their lease");
+    }
+    {
+        SearchContextPool::Lease search = pool.acquire();
+        check(search->getSharedMap() == map && pathLength(search) == shortest, "costs aren't visible to the next lease");
+    }
+    pool.setSearchMode(PathFinder::SearchMode::WAVE);
+
+    {
+        SearchContextPool::Lease search = pool.acquire();
+        search->setEndpoints(0, 0, WIDTH - 1, 0);
+        search->buildFlowField();
+        search->buildComponents();
+        search->buildLandmarks(2);
+        search->setWaveStorage(PathFinder::WaveStorage::PAGED);
+        check(search->hasFlowField() && search->hasComponents() && search->hasLandmarks(), "a lease builds its own per-map state");
+    }
+    {
+        SearchContextPool::Lease search = pool.acquire();
+        check(!search->hasFlowField(), "a flow field isn't handed to the next lease");
+        check(!search->hasComponents(), "components aren't handed to the next lease");
+        check(!search->hasLandmarks(), "landmarks aren't handed to the next lease");
+        check(search->getWaveStorage() == PathFinder::WaveStorage::DENSE, "the next lease gets DENSE storage");
+        check(pathLength(search) == shortest, "the next lease finds the shortest path");
+    }
+
+    check(pool.getContextCount() == 1, "one context served every lease");
+
+    if (failures) {
+        printf("FAILED: %d check(s)\n", failures);
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
\ No newline at end of file